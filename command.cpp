@@ -0,0 +1,153 @@
+#include <Arduino.h>
+#include "command.h"
+#include "config.h"
+
+// 정수 값 자릿수 제한 (int 오버플로 방지, 그 이상은 ArduinoJson 으로 넘김)
+static const uint8_t MAX_INT_DIGITS = 9;
+
+static char* skipWs(char* p) {
+  while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+  return p;
+}
+
+static bool keyIs(const char* key, size_t len, const char* name) {
+  return strlen(name) == len && memcmp(key, name, len) == 0;
+}
+
+// 정수형 키이면 저장 위치를, 아니면 nullptr 를 돌려준다
+static int* intField(Command& cmd, const char* key, size_t len) {
+  if (keyIs(key, len, "control")) return &cmd.control;
+  if (keyIs(key, len, "time"))    return &cmd.time;
+  if (keyIs(key, len, "water"))   return &cmd.water;
+  if (keyIs(key, len, "timer"))   return &cmd.timer;
+  if (keyIs(key, len, "seq"))     return &cmd.seq;
+  if (keyIs(key, len, "dose"))    return &cmd.dose;
+  if (keyIs(key, len, "count"))   return &cmd.count;
+  return nullptr;
+}
+
+// setting 장비 개수 키
+static uint8_t* countField(Command& cmd, const char* key, size_t len) {
+  if (keyIs(key, len, "cup"))    return &cmd.setting.cup;
+  if (keyIs(key, len, "ramen"))  return &cmd.setting.ramen;
+  if (keyIs(key, len, "powder")) return &cmd.setting.powder;
+  if (keyIs(key, len, "cooker")) return &cmd.setting.cooker;
+  if (keyIs(key, len, "outlet")) return &cmd.setting.outlet;
+  return nullptr;
+}
+
+// 숫자 키별 허용 범위. 음수 / 0 은 핸들러가 각자 에러로 처리하므로 위쪽만 막는다.
+// setting 개수는 uint8_t 에 담기므로 0~255 (장비별 최대는 validateRules 가 검사).
+static bool numberInRange(const char* key, size_t len, long v) {
+  if (keyIs(key, len, "time"))  return v <= CMD_TIME_MAX;
+  if (keyIs(key, len, "water")) return v <= CMD_WATER_MAX_ML;
+  if (keyIs(key, len, "timer")) return v <= CMD_TIMER_MAX;
+  if (keyIs(key, len, "dose"))  return v <= CMD_DOSE_MAX_MG;
+  if (keyIs(key, len, "count")) return v <= CUP_QUEUE_MAX;
+  if (keyIs(key, len, "cup") || keyIs(key, len, "ramen") || keyIs(key, len, "powder") ||
+      keyIs(key, len, "cooker") || keyIs(key, len, "outlet")) {
+    return v >= 0 && v <= 0xFF;
+  }
+  return true;
+}
+
+bool commandNumberInRange(const char* key, long v) {
+  return numberInRange(key, strlen(key), v);
+}
+
+static const char** strField(Command& cmd, const char* key, size_t len) {
+  if (keyIs(key, len, "device"))   return &cmd.device;
+  if (keyIs(key, len, "function")) return &cmd.function;
+  return nullptr;
+}
+
+// 닫는 따옴표 위치를 찾는다. escape 가 있으면 스키마 밖으로 본다.
+static CommandParseResult scanString(char*& p) {
+  for (;; p++) {
+    if (*p == '\0') return CMD_PARSE_ERROR;
+    if (*p == '\\') return CMD_UNKNOWN_SHAPE;
+    if (*p == '"') return CMD_OK;
+  }
+}
+
+CommandParseResult tokenizeCommand(char* json, Command& cmd) {
+  // 문자열 값의 닫는 따옴표 위치 (파싱 성공 시 '\0' 으로 치환)
+  char* strEnds[2];
+  uint8_t strEndCount = 0;
+  CommandParseResult r;
+
+  char* p = skipWs(json);
+  if (*p != '{') return (*p == '[') ? CMD_UNKNOWN_SHAPE : CMD_PARSE_ERROR;
+  p = skipWs(p + 1);
+
+  if (*p != '}') {
+    for (;;) {
+      // 1. 키
+      if (*p != '"') return CMD_PARSE_ERROR;
+      char* key = ++p;
+      if ((r = scanString(p)) != CMD_OK) return r;
+      size_t keyLen = p - key;
+
+      p = skipWs(p + 1);
+      if (*p != ':') return CMD_PARSE_ERROR;
+      p = skipWs(p + 1);
+
+      // 2. 값
+      if (*p == '"') {
+        char* val = ++p;
+        if ((r = scanString(p)) != CMD_OK) return r;
+
+        const char** dst = strField(cmd, key, keyLen);
+        if (dst) {
+          if (strEndCount >= 2) return CMD_UNKNOWN_SHAPE;  // 중복 키
+          *dst = val;
+          strEnds[strEndCount++] = p;
+        } else if (intField(cmd, key, keyLen) || countField(cmd, key, keyLen)) {
+          return CMD_UNKNOWN_SHAPE;  // 숫자 키에 문자열 값
+        }
+        p++;
+      } else if (*p == '-' || (*p >= '0' && *p <= '9')) {
+        bool neg = (*p == '-');
+        if (neg) p++;
+        if (*p < '0' || *p > '9') return CMD_PARSE_ERROR;
+
+        long v = 0;
+        uint8_t digits = 0;
+        while (*p >= '0' && *p <= '9') {
+          if (++digits > MAX_INT_DIGITS) return CMD_UNKNOWN_SHAPE;
+          v = v * 10 + (*p++ - '0');
+        }
+        if (*p == '.' || *p == 'e' || *p == 'E') return CMD_UNKNOWN_SHAPE;  // 실수
+        if (neg) v = -v;
+        if (!numberInRange(key, keyLen, v)) return CMD_RANGE_ERROR;
+
+        int* iv = intField(cmd, key, keyLen);
+        uint8_t* cv = countField(cmd, key, keyLen);
+        if (iv) {
+          *iv = (int)v;
+        } else if (cv) {
+          *cv = (uint8_t)v;
+        } else if (strField(cmd, key, keyLen)) {
+          return CMD_UNKNOWN_SHAPE;  // 문자열 키에 숫자 값
+        }
+      } else if (*p == '{' || *p == '[' || *p == 't' || *p == 'f' || *p == 'n') {
+        return CMD_UNKNOWN_SHAPE;  // 중첩 구조, true/false/null
+      } else {
+        return CMD_PARSE_ERROR;
+      }
+
+      // 3. 구분자
+      p = skipWs(p);
+      if (*p == ',') {
+        p = skipWs(p + 1);
+        continue;
+      }
+      if (*p == '}') break;
+      return CMD_PARSE_ERROR;
+    }
+  }
+
+  // 제자리 종료: 닫는 따옴표를 '\0' 으로
+  for (uint8_t i = 0; i < strEndCount; i++) *strEnds[i] = '\0';
+  return CMD_OK;
+}
@@ -0,0 +1,41 @@
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <Arduino.h>
+#include "state.h"
+
+// =======================================================
+// === 수신 명령 (평면 스키마)
+// =======================================================
+// 명령이 사용하는 키만 담는다. 문자열 필드는 RX 버퍼 안을 그대로 가리킨다.
+// 값이 없는 필드는 기존 `doc["key"] | 0` 과 같이 "" / 0 으로 둔다.
+struct Command {
+  const char* device   = "";
+  const char* function = "";
+  int control = 0;
+  int time    = 0;
+  int water   = 0;
+  int timer   = 0;
+  int seq     = 0;  // ping 일련번호 (시각 동기)
+  int dose    = 0;  // 스프 목표량 / 실제 무게 (mg)
+  int count   = 0;  // 용기 연속 배출 개수
+  Setting setting;  // device == "setting" 일 때의 장비 개수
+};
+
+enum CommandParseResult {
+  CMD_OK,             // 스키마 안에서 파싱 완료
+  CMD_UNKNOWN_SHAPE,  // 문법은 맞을 수 있으나 스키마 밖 (중첩, escape, 실수 등) -> ArduinoJson 으로 재시도
+  CMD_PARSE_ERROR,    // JSON 문법 오류
+  CMD_RANGE_ERROR     // 숫자 값이 키의 허용 범위 밖 (잘라 쓰지 않고 명령 거절)
+};
+
+// RX 버퍼를 한 번 훑어 필드를 추출한다 (복사/DOM 없음).
+// CMD_OK 인 경우에만 문자열 값 끝에 '\0' 을 써넣어 버퍼를 제자리에서 잘라 쓴다.
+// 그 외 결과에서는 버퍼를 건드리지 않으므로 원문 그대로 재파싱할 수 있다.
+CommandParseResult tokenizeCommand(char* json, Command& cmd);
+
+// 숫자 키 key 의 값 v 가 허용 범위 안인지 (ArduinoJson 재파싱 경로도 같은 기준)
+// 범위가 없는 키 (control, seq, 스키마 밖 키) 는 true.
+bool commandNumberInRange(const char* key, long v);
+
+#endif // COMMAND_H
@@ -51,15 +51,103 @@ const uint8_t OUTLET_LOAD_AIN[4]  = {28, 30, 32, 34};
 const uint8_t OUTLET_USONIC_AIN[4]= {29, 31, 33, 35};
 
 // ===== 5. cooker 핀맵 =====
-const uint8_t COOKER_IND_SIG[4]   = {32,33,34,35};
-const uint8_t COOKER_WTR_SIG[4]   = {36,37,38,39};
-const uint8_t COOKER_CURR_AIN[4]  = {A6, A7, A8, A9};
+// 출력 배선이 확인된 것은 1, 2번뿐이다. 3, 4번은 핀 자리만 있고 5~8번은 핀맵이 없다.
+// setting 의 cooker 개수는 COOKER_WIRED 까지만 받는다 (validateRules).
+const uint8_t COOKER_PIN_COUNT    = 4;
+const uint8_t COOKER_WIRED        = 2;
+const uint8_t COOKER_IND_SIG[COOKER_PIN_COUNT]  = {32,33,34,35};
+const uint8_t COOKER_WTR_SIG[COOKER_PIN_COUNT]  = {36,37,38,39};
+const uint8_t COOKER_CURR_AIN[COOKER_PIN_COUNT] = {A6, A7, A8, A9};
+static_assert(COOKER_WIRED <= COOKER_PIN_COUNT && COOKER_PIN_COUNT <= MAX_COOKER, "cooker pin map");
 
 // ===== 6. door 핀맵 =====
 const uint8_t DOOR_SENSOR1_PIN = 14;
 const uint8_t DOOR_SENSOR2_PIN = 15;
 
-// ===== 7. 동작 파라미터 =====
+// ===== 7. 통신 경로 =====
+#define TRANSPORT_UART        0
+#define TRANSPORT_NATIVE_USB  1
+#define TRANSPORT_AUTO        2
+
+#ifndef TRANSPORT
+#define TRANSPORT TRANSPORT_UART
+#endif
+
+const unsigned long UART_BAUD = 115200;
+const unsigned long TRANSPORT_AUTO_WAIT_MS = 2000; // AUTO: 네이티브 USB 연결 대기 시간
+
+// ===== 8. 동작 파라미터 =====
 const unsigned long PUBLISH_INTERVAL_MS = 100; // 0.1초
 
+// ===== 스케줄러 (타이머 인터럽트 틱, 주기는 틱=1ms 단위) =====
+const unsigned long SCHED_TICK_HZ = 1000;
+const uint8_t  MAX_TASKS         = 8;
+const uint16_t CONTROL_PERIOD_MS = 1;    // 리밋 감시 / 마감 감시 (1kHz)
+const uint16_t RX_PERIOD_MS      = 1;    // 명령 수신
+const uint16_t SAMPLE_PERIOD_MS  = 10;   // 보고 구간 통계용 연속 샘플 (구간당 10회)
+const uint16_t SENSE_PERIOD_MS   = 100;  // 센서 읽기 (보고 직전)
+const size_t TELEMETRY_FRAME_SIZE = 1536;       // 상태 프레임 송신 버퍼 (최대 장비 조합 기준: cup 4 + cooker 8)
+
+const size_t RX_BUFFER_SIZE = 512;              // 수신 명령 1건 최대 길이 ('[' ']' 제외)
+const size_t TX_QUEUE_SIZE = 2048;              // 송신 큐 (상태 프레임 1건 + 이벤트 / 로그 여유)
+const unsigned long MEM_REPORT_INTERVAL_MS = 60000; // 메모리 / 버퍼 사용량 정기 보고 (0: query 때만)
+
+// ===== 동작 마감 감시 (리밋 센서 고장 대비, 정상 동작 시간보다 넉넉히) =====
+const uint8_t MAX_MOTIONS = 16;                        // 동시에 감시하는 출력 수
+const unsigned long CUP_DISPENSE_TIMEOUT_MS   = 5000;  // 용기 1회 배출
+const unsigned long RAMEN_LIFT_TIMEOUT_MS     = 15000; // 면 상승 / 하강
+const unsigned long RAMEN_EJECT_TIMEOUT_MS    = 8000;  // 면 배출 전진 / 복귀 (각각)
+const unsigned long POWDER_TIMEOUT_MARGIN_MS  = 1000;  // 스프 배출 시간 + 여유
+const unsigned long OUTLET_DOOR_TIMEOUT_MS    = 6000;  // 배출구 열림 / 닫힘
+const unsigned long WATCHDOG_TIMEOUT_MS       = 3000;  // loop 가 이 시간 이상 멈추면 리셋
+const unsigned long COOKER_TIMEOUT_MARGIN_MS  = 2000;  // 급수 / 가열 시간 + 여유
+
+// ===== 용기 연속 배출 (cup startdispense 의 count) =====
+const uint16_t CUP_QUEUE_MAX        = 99;   // 채널당 최대 대기 개수
+const unsigned long CUP_CYCLE_GAP_MS = 100; // 연속 배출 사이 모터 정지 시간
+const uint8_t CUP_STOCK_EMPTY_LEVEL = HIGH; // 재고 센서가 비었을 때 레벨 (INPUT_PULLUP, 감지 시 LOW)
+
+// ===== 배출구 그릇 전달 (로드셀 값, set_scale(10) 기준 단위) =====
+const bool OUTLET_AUTO_HANDOFF = true;            // 놓이면 문 열기, 가져가면 문 닫기 (false: 명령으로만)
+const int OUTLET_PLACE_LOAD    = 100;             // 이 값 이상이 유지되면 그릇 놓임
+const int OUTLET_REMOVE_LOAD   = 30;              // 이 값 미만이 유지되면 가져감 (놓임 값보다 낮게)
+const unsigned long OUTLET_PLACE_HOLD_MS  = 300;  // 놓임 유지 시간 (내려놓는 충격 무시)
+const unsigned long OUTLET_REMOVE_HOLD_MS = 2000; // 빠짐 유지 시간 (잠깐 들었다 놓는 경우 무시)
+
+// ===== 스프 정량 배출 (powder dose, 단위 mg) =====
+const unsigned long POWDER_SAMPLE_MS   = 10;       // 오거 부하 전류 샘플 주기
+const float POWDER_DEFAULT_MG_PER_S    = 1500.0f;  // 보정 전 기본 유량
+const float POWDER_DEFAULT_REF_LOAD    = 200.0f;   // 보정 전 기준 부하 (ADC)
+const float POWDER_MIN_REF_LOAD        = 20.0f;    // 이보다 낮은 평균 부하는 센서 없음으로 보고 기준 부하 유지
+const float POWDER_LOAD_MIN_RATIO      = 0.5f;     // 부하 보정 범위 (기준 부하 대비)
+const float POWDER_LOAD_MAX_RATIO      = 2.0f;
+const float POWDER_LEARN_GAIN          = 0.3f;     // 보정 1회 반영 비율 (첫 보정은 그대로)
+const float POWDER_MAX_TIME_RATIO      = 3.0f;     // 예상 시간의 이 배수 안에 못 채우면 부족 정지 (최저 부하 보정 0.5 보다 여유)
+
+// ===== 조리 프로그램 (cooker startcook 의 water / timer) =====
+const unsigned long COOKER_WATER_ML_PER_SEC = 25;    // 급수 밸브 유량 (water 단위: ml)
+const unsigned long COOKER_TIMER_UNIT_MS    = 1000;  // timer 단위: 초
+
+// ===== 명령 숫자 값 상한 (넘으면 "value out of range", ms 환산이 32비트를 넘지 않게) =====
+const long CMD_TIME_MAX     = 36000;    // powder time (0.1초 단위) 1시간
+const long CMD_WATER_MAX_ML = 20000;    // cooker water (ml)
+const long CMD_TIMER_MAX    = 7200;     // cooker timer (초) 2시간
+const long CMD_DOSE_MAX_MG  = 1000000;  // powder dose / calibrate (mg) 1kg
+
+// 스키마 밖 명령(중첩, escape, 실수 등)을 ArduinoJson 으로 재파싱 (0 이면 parse fail 처리)
+#ifndef JSON_FALLBACK
+#define JSON_FALLBACK 1
+#endif
+
+// 로그 레벨 하한: 0 DEBUG, 1 INFO, 2 WARN, 3 ERROR, 4 로그 끔 (미만 레벨은 컴파일에서 제외)
+#ifndef LOG_LEVEL_MIN
+#define LOG_LEVEL_MIN 1
+#endif
+
+// 로그를 바이너리 레코드 대신 문자열로 출력 (시리얼 모니터로 직접 볼 때)
+// #define LOG_TEXT
+
+// 텔레메트리 직렬화 벤치마크 (setting 적용 직후 DOM 방식과 비교 출력)
+// #define TELEMETRY_BENCH
+
 #endif // CONFIG_H
\ No newline at end of file
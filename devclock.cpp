@@ -0,0 +1,12 @@
+#include <Arduino.h>
+#include "devclock.h"
+
+static uint32_t lastMicros = 0;
+static uint32_t wraps = 0;
+
+uint64_t deviceMicros() {
+  uint32_t now = micros();
+  if (now < lastMicros) wraps++;
+  lastMicros = now;
+  return ((uint64_t)wraps << 32) | now;
+}
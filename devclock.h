@@ -0,0 +1,16 @@
+#ifndef DEVCLOCK_H
+#define DEVCLOCK_H
+
+#include <Arduino.h>
+
+// =======================================================
+// === 기기 시각 (단조 증가 µs)
+// =======================================================
+// micros() 는 32비트라 약 71.6분마다 0 으로 돌아간다. 돌아간 횟수를 세어
+// 64비트로 늘린 값을 모든 프레임 / 로그의 "ts" 로 쓴다.
+// wrap 한 주기 안에 한 번 이상 호출되어야 하며, 제어 작업(1ms)이 매번 호출한다.
+// loop 문맥 전용 (ISR 에서 호출하지 않음).
+
+uint64_t deviceMicros();
+
+#endif // DEVCLOCK_H
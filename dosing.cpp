@@ -0,0 +1,170 @@
+#include <Arduino.h>
+#include "dosing.h"
+#include "config.h"
+#include "state.h"
+#include "store.h"
+#include "supervisor.h"
+#include "reporting.h"
+#include "log.h"
+
+// 채널별 유량 모델 (플래시에 저장되는 부분)
+struct PowderModel {
+  float rate;            // 기준 부하에서의 유량 (mg/s)
+  float refLoad;         // 기준 부하 (ADC)
+  uint32_t calibrations; // 반영된 보정 횟수
+};
+
+// 배출 1회 진행 상태
+struct PowderDose {
+  bool active;
+  bool hasResult;         // 보정에 쓸 직전 배출 결과가 있음
+  unsigned long startMs;
+  unsigned long lastSampleMs;
+  unsigned long maxMs;    // 이 시간이 지나면 부족 정지
+  unsigned long targetMg;
+  float dosedMg;          // 추정 누적 배출량
+  float normSec;          // ∫ clamp(부하/기준부하) dt (초): 보정 시 rate = 실제량 / normSec
+  float loadSum;
+  uint32_t loadCount;
+};
+
+static PowderModel models[MAX_POWDER];
+static PowderDose doses[MAX_POWDER];
+static bool modelsDirty = false;  // 저장 대기 중인 보정
+static uint8_t dirtyIdx = 0;      // 마지막으로 보정한 채널 (저장 실패 보고용)
+
+void loadPowderModels() {
+  if (loadStore(STORE_POWDER_MODEL, models, sizeof(models))) return;
+
+  for (uint8_t i = 0; i < MAX_POWDER; i++) {
+    models[i].rate = POWDER_DEFAULT_MG_PER_S;
+    models[i].refLoad = POWDER_DEFAULT_REF_LOAD;
+    models[i].calibrations = 0;
+  }
+}
+
+static void finishDose(uint8_t idx) {
+  digitalWrite(POWDER_MOTOR_OUT[idx], LOW);
+  releaseMotion(POWDER_MOTOR_OUT[idx]);
+  doses[idx].active = false;
+  doses[idx].hasResult = true;
+}
+
+// 마감 초과 (supervisor 가 출력은 이미 끔): 결과는 보정에 쓰지 않음
+static void abortPowderDose(uint8_t idx) {
+  doses[idx].active = false;
+  doses[idx].hasResult = false;
+}
+
+bool startPowderDose(uint8_t idx, unsigned long targetMg) {
+  PowderDose& d = doses[idx];
+  if (d.active) return false;
+
+  const PowderModel& m = models[idx];
+  unsigned long expectMs = (unsigned long)(targetMg * 1000.0f / m.rate);
+
+  d.active = true;
+  d.hasResult = false;
+  d.startMs = d.lastSampleMs = millis();
+  d.maxMs = (unsigned long)(expectMs * POWDER_MAX_TIME_RATIO) + POWDER_SAMPLE_MS;
+  d.targetMg = targetMg;
+  d.dosedMg = 0;
+  d.normSec = 0;
+  d.loadSum = 0;
+  d.loadCount = 0;
+
+  LOG(MSG_POWDER_DOSE_START, idx + 1, targetMg, expectMs);
+  digitalWrite(POWDER_MOTOR_OUT[idx], HIGH);
+  superviseMotion(POWDER_MOTOR_OUT[idx], "powder", idx, "dose",
+                  d.maxMs + POWDER_TIMEOUT_MARGIN_MS, abortPowderDose);
+  return true;
+}
+
+void stopPowderDose(uint8_t idx) {
+  if (!doses[idx].active) return;
+  finishDose(idx);
+  doses[idx].hasResult = false;  // 중간 정지한 배출은 보정에 쓰지 않음
+}
+
+// 스프 모터(정량 / 시간 배출)가 모두 멈춤
+static bool powderMotorsIdle() {
+  for (uint8_t i = 0; i < current.powder; i++) {
+    if (digitalRead(POWDER_MOTOR_OUT[i]) == HIGH) return false;
+  }
+  return true;
+}
+
+static bool saveModels() {
+  modelsDirty = false;
+  return saveStore(STORE_POWDER_MODEL, models, sizeof(models));
+}
+
+void checkPowderDose() {
+  unsigned long now = millis();
+
+  if (modelsDirty && powderMotorsIdle() && !saveModels()) {
+    sendError("powder", dirtyIdx + 1, "calibration not saved");
+  }
+
+  for (uint8_t i = 0; i < current.powder; i++) {
+    PowderDose& d = doses[i];
+    if (!d.active || now - d.lastSampleMs < POWDER_SAMPLE_MS) continue;
+
+    const PowderModel& m = models[i];
+    float dt = (now - d.lastSampleMs) / 1000.0f;
+    int load = analogRead(POWDER_CURR_AIN[i]);
+    d.lastSampleMs = now;
+
+    // 부하가 높으면 오거가 가루를 더 밀어내는 중 (호퍼 가득, 뭉침 등)
+    float ratio = load / m.refLoad;
+    if (ratio < POWDER_LOAD_MIN_RATIO) ratio = POWDER_LOAD_MIN_RATIO;
+    if (ratio > POWDER_LOAD_MAX_RATIO) ratio = POWDER_LOAD_MAX_RATIO;
+
+    d.normSec += ratio * dt;
+    d.dosedMg = m.rate * d.normSec;
+    d.loadSum += load;
+    d.loadCount++;
+
+    unsigned long elapsed = now - d.startMs;
+    if (d.dosedMg >= d.targetMg) {
+      finishDose(i);
+      LOG(MSG_POWDER_DOSE_DONE, i + 1, (long)d.dosedMg, elapsed);
+      sendEvent("powder", i + 1, "dosed");
+    } else if (elapsed >= d.maxMs) {
+      finishDose(i);
+      LOG(MSG_POWDER_DOSE_SHORT, i + 1, (long)d.dosedMg, d.targetMg);
+      sendEvent("powder", i + 1, "doseshort");
+    }
+  }
+}
+
+CalibrateResult calibratePowderDose(uint8_t idx, unsigned long actualMg) {
+  PowderDose& d = doses[idx];
+  if (!d.hasResult || d.normSec <= 0.0f) return CALIBRATE_NO_DOSE;
+
+  PowderModel& m = models[idx];
+  float rateSeen = actualMg / d.normSec;
+  float loadSeen = d.loadCount ? d.loadSum / d.loadCount : 0.0f;
+
+  // 첫 보정은 그대로, 이후는 지수 평균으로 서서히 따라감
+  float gain = m.calibrations ? POWDER_LEARN_GAIN : 1.0f;
+  m.rate += gain * (rateSeen - m.rate);
+  if (loadSeen >= POWDER_MIN_REF_LOAD) m.refLoad += gain * (loadSeen - m.refLoad);
+  m.calibrations++;
+  d.hasResult = false;  // 같은 배출로 두 번 보정하지 않음
+
+  LOG(MSG_POWDER_MODEL, idx + 1, (long)m.rate, (long)m.refLoad);
+
+  modelsDirty = true;
+  dirtyIdx = idx;
+  if (!powderMotorsIdle()) return CALIBRATE_OK;  // 배출이 끝난 뒤 checkPowderDose 에서
+  return saveModels() ? CALIBRATE_OK : CALIBRATE_NOT_SAVED;
+}
+
+bool powderDoseActive(uint8_t idx) {
+  return doses[idx].active;
+}
+
+unsigned long powderDosedMg(uint8_t idx) {
+  return (unsigned long)doses[idx].dosedMg;
+}
@@ -0,0 +1,40 @@
+#ifndef DOSING_H
+#define DOSING_H
+
+#include <Arduino.h>
+
+// =======================================================
+// === 스프 정량 배출 (목표량 mg, 폐루프)
+// =======================================================
+// 채널마다 유량 모델(기준 부하에서의 mg/s)을 두고, 배출 중에는 오거 부하 전류
+// (POWDER_CURR_AIN) 로 유량을 보정해 누적 배출량을 추정한다.
+//   배출량 += rate * clamp(부하 / 기준부하) * dt
+// 추정치가 목표에 닿으면 정지하고, 예상 시간의 POWDER_MAX_TIME_RATIO 배가 지나도
+// 못 채우면 (호퍼 비었음 등) 부족 정지한다. 8채널 모두 동시에 배출할 수 있다.
+// 호스트가 실제 무게를 알려주면(calibrate) 직전 배출 기준으로 모델을 갱신해 플래시에 저장한다.
+
+// 저장된 모델 읽기 (없으면 config.h 기본값)
+void loadPowderModels();
+
+// 목표량 배출 시작 (이미 배출 중이면 false)
+bool startPowderDose(uint8_t idx, unsigned long targetMg);
+void stopPowderDose(uint8_t idx);
+
+// 제어 작업에서 호출: 부하 샘플, 누적 배출량, 정지 판단
+void checkPowderDose();
+
+enum CalibrateResult {
+  CALIBRATE_OK,         // 갱신 + 저장 (스프 모터가 돌고 있으면 모두 멈춘 뒤 저장)
+  CALIBRATE_NO_DOSE,    // 보정에 쓸 직전 배출 없음
+  CALIBRATE_NOT_SAVED   // 모델은 갱신했지만 플래시 저장 실패
+};
+
+// 직전 배출의 실제 무게(mg) 로 모델 갱신 + 저장.
+// 플래시 쓰기 동안 인터럽트가 멈추므로 저장은 스프 모터가 모두 멈춰 있을 때만 하고,
+// 그렇지 않으면 checkPowderDose 가 멈춘 뒤에 저장한다 (실패 시 "calibration not saved").
+CalibrateResult calibratePowderDose(uint8_t idx, unsigned long actualMg);
+
+bool powderDoseActive(uint8_t idx);
+unsigned long powderDosedMg(uint8_t idx);  // 진행 중 또는 직전 배출 추정량
+
+#endif // DOSING_H
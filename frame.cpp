@@ -0,0 +1,91 @@
+#include <Arduino.h>
+#include "frame.h"
+
+// 두 자리씩 변환하기 위한 숫자 쌍 테이블 ("00" ~ "99")
+static const char DIGIT_PAIRS[201] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+void FrameWriter::raw(const char* s, size_t n) {
+  if (_len + n > _cap) {
+    _overflow = true;
+    n = _cap - _len;
+  }
+  memcpy(_buf + _len, s, n);
+  _len += n;
+}
+
+void FrameWriter::uinteger(unsigned long v) {
+  char tmp[12];
+  char* p = tmp + sizeof(tmp);
+
+  // 뒤에서부터 두 자리씩 채움
+  while (v >= 100) {
+    unsigned long q = v / 100;
+    unsigned r = (unsigned)(v - q * 100) * 2;
+    v = q;
+    *--p = DIGIT_PAIRS[r + 1];
+    *--p = DIGIT_PAIRS[r];
+  }
+  if (v >= 10) {
+    unsigned r = (unsigned)v * 2;
+    *--p = DIGIT_PAIRS[r + 1];
+    *--p = DIGIT_PAIRS[r];
+  } else {
+    *--p = (char)('0' + v);
+  }
+
+  raw(p, (size_t)(tmp + sizeof(tmp) - p));
+}
+
+void FrameWriter::uinteger64(uint64_t v) {
+  if (v <= 0xFFFFFFFFUL) {
+    uinteger((unsigned long)v);
+    return;
+  }
+
+  // 앞부분은 재귀로, 뒤 9자리는 0 을 채워 32비트 변환 재사용
+  uinteger64(v / 1000000000UL);
+  unsigned long low = (unsigned long)(v % 1000000000UL);
+  char tmp[9];
+  for (int k = 8; k >= 0; k--) {
+    tmp[k] = (char)('0' + low % 10);
+    low /= 10;
+  }
+  raw(tmp, sizeof(tmp));
+}
+
+void FrameWriter::integer(long v) {
+  if (v < 0) {
+    raw('-');
+    uinteger(0UL - (unsigned long)v);  // LONG_MIN 에서도 안전
+  } else {
+    uinteger((unsigned long)v);
+  }
+}
+
+void FrameWriter::str(const char* s) {
+  raw('"');
+  for (; *s; s++) {
+    char c = *s;
+    switch (c) {
+      case '"':  lit("\\\""); break;
+      case '\\': lit("\\\\"); break;
+      case '\b': lit("\\b"); break;
+      case '\f': lit("\\f"); break;
+      case '\n': lit("\\n"); break;
+      case '\r': lit("\\r"); break;
+      case '\t': lit("\\t"); break;
+      default:   raw(c); break;
+    }
+  }
+  raw('"');
+}
@@ -0,0 +1,51 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <Arduino.h>
+
+// =======================================================
+// === 고정 버퍼 JSON 프레임 작성기
+// =======================================================
+// 스키마가 고정된 송신 프레임을 ArduinoJson DOM 없이 미리 잡아둔 버퍼에
+// 직접 써넣고, 완성된 프레임을 한 번의 write로 내보낸다.
+// 출력 형식은 serializeJson()과 동일 (공백 없는 compact JSON).
+
+class FrameWriter {
+public:
+  FrameWriter(char* buf, size_t cap) : _buf(buf), _cap(cap), _len(0), _overflow(false) {}
+
+  void reset() { _len = 0; _overflow = false; }
+
+  // 미리 계산된 리터럴 (키 + 구분자 등) 을 그대로 복사
+  template <size_t N>
+  void lit(const char (&s)[N]) { raw(s, N - 1); }
+
+  void raw(char c) {
+    if (_len < _cap) _buf[_len++] = c;
+    else _overflow = true;
+  }
+  void raw(const char* s, size_t n);
+
+  // 정수 (ArduinoJson 과 같은 10진수 표기)
+  void integer(long v);
+  void uinteger(unsigned long v);
+  void uinteger64(uint64_t v);  // 기기 시각 (µs) 등 32비트를 넘는 값
+
+  // 따옴표 포함 JSON 문자열 (ArduinoJson 과 같은 규칙으로 escape)
+  void str(const char* s);
+
+  size_t length() const { return _len; }
+  bool overflowed() const { return _overflow; }
+  const char* data() const { return _buf; }
+
+  // 완성된 프레임을 한 번에 전송
+  size_t flushTo(Print& out) const { return out.write((const uint8_t*)_buf, _len); }
+
+private:
+  char* _buf;
+  size_t _cap;
+  size_t _len;
+  bool _overflow;
+};
+
+#endif // FRAME_H
@@ -0,0 +1,135 @@
+#include <Arduino.h>
+#include <stdio.h>
+#include <time.h>
+
+static uint8_t pinModes[HOST_PIN_COUNT];
+static int pinLevels[HOST_PIN_COUNT];
+static int analogValues[HOST_PIN_COUNT];
+static void (*pinIsr[HOST_PIN_COUNT])();
+static int pinIsrMode[HOST_PIN_COUNT];
+
+// ===== 디지털 / 아날로그 =====
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= HOST_PIN_COUNT) return;
+  pinModes[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= HOST_PIN_COUNT) return;
+  pinLevels[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= HOST_PIN_COUNT) return LOW;
+  return pinLevels[pin];
+}
+
+int analogRead(uint8_t pin) {
+  if (pin >= HOST_PIN_COUNT) return 0;
+  return analogValues[pin];
+}
+
+void analogReadResolution(int bits) { (void)bits; }
+
+void hostSetPin(uint8_t pin, int level) {
+  if (pin >= HOST_PIN_COUNT) return;
+  int prev = pinLevels[pin];
+  pinLevels[pin] = level ? HIGH : LOW;
+
+  // 인터럽트 흉내: 모드에 맞는 변화면 즉시 ISR 호출
+  void (*isr)() = pinIsr[pin];
+  if (!isr || prev == pinLevels[pin]) return;
+  int mode = pinIsrMode[pin];
+  if (mode == CHANGE || (mode == RISING && pinLevels[pin] == HIGH) ||
+      (mode == FALLING && pinLevels[pin] == LOW)) {
+    isr();
+  }
+}
+
+// ===== 인터럽트 =====
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+  if (pin >= HOST_PIN_COUNT) return;
+  pinIsr[pin] = isr;
+  pinIsrMode[pin] = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+  if (pin >= HOST_PIN_COUNT) return;
+  pinIsr[pin] = nullptr;
+}
+
+void hostSetAnalog(uint8_t pin, int value) {
+  if (pin >= HOST_PIN_COUNT) return;
+  analogValues[pin] = value;
+}
+
+// ===== 시간 =====
+static unsigned long long monotonicUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static const unsigned long long bootUs = monotonicUs();
+
+// 가상 시각 (시뮬레이터): hostAdvanceMicros() 로만 흐르고 delay 는 시각만 넘긴다
+static bool virtualTime = false;
+static unsigned long long virtualUs = 0;
+
+void hostUseVirtualTime() { virtualTime = true; }
+void hostAdvanceMicros(unsigned long long us) { virtualUs += us; }
+
+static unsigned long long elapsedUs() {
+  return virtualTime ? virtualUs : monotonicUs() - bootUs;
+}
+
+// Due 와 같이 32비트로 넘어가도록 자른다
+unsigned long micros() { return (uint32_t)elapsedUs(); }
+unsigned long millis() { return (uint32_t)(elapsedUs() / 1000); }
+
+void delay(unsigned long ms) {
+  if (virtualTime) {
+    virtualUs += ms * 1000ULL;
+    return;
+  }
+  struct timespec ts = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+  nanosleep(&ts, nullptr);
+}
+
+void delayMicroseconds(unsigned int us) {
+  if (virtualTime) {
+    virtualUs += us;
+    return;
+  }
+  struct timespec ts = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000L };
+  nanosleep(&ts, nullptr);
+}
+
+// ===== Print =====
+size_t Print::print(long v, int base) {
+  if (base == DEC) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%ld", v);
+    return write(buf);
+  }
+  return print((unsigned long)v, base);
+}
+
+size_t Print::print(unsigned long v, int base) {
+  char buf[40];
+  char* p = buf + sizeof(buf);
+  *--p = '\0';
+  if (base < 2) base = DEC;
+  do {
+    int d = (int)(v % base);
+    *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+    v /= base;
+  } while (v);
+  return write(p);
+}
+
+size_t Print::print(double v, int digits) {
+  char buf[40];
+  snprintf(buf, sizeof(buf), "%.*f", digits, v);
+  return write(buf);
+}
@@ -0,0 +1,119 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// =======================================================
+// === 호스트(리눅스) 빌드용 Arduino API 대체
+// =======================================================
+// 펌웨어 소스를 수정 없이 PC 에서 컴파일하기 위한 최소 구현.
+// 핀은 메모리 배열로 흉내내며, 시간은 CLOCK_MONOTONIC 기준이다 (시뮬레이터는 가상 시각).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE  2
+#define FALLING 3
+#define RISING  4
+
+#define DEC 10
+
+// Due 아날로그 핀 번호 (A0 = 54)
+enum { A0 = 54, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, A11 };
+
+const uint8_t HOST_PIN_COUNT = 80;
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+// ===== 디지털 / 아날로그 =====
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogReadResolution(int bits);
+
+// ===== 시간 =====
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// ===== 인터럽트 (호스트는 단일 스레드이므로 비움) =====
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// 핀 변화 인터럽트: hostSetPin() 으로 입력이 바뀔 때 호출된다
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+// ===== 호스트 전용: 입력 핀/아날로그 값 주입 =====
+void hostSetPin(uint8_t pin, int level);
+void hostSetAnalog(uint8_t pin, int value);
+
+// ===== 호스트 전용: 가상 시각 (시뮬레이터, setup() 전에 켠다) =====
+void hostUseVirtualTime();
+void hostAdvanceMicros(unsigned long long us);
+
+// ===== String (펌웨어가 쓰는 부분만) =====
+class String {
+public:
+  String(const char* s = "") : _s(s) {}
+  String& operator=(const char* s) { _s = s; return *this; }
+  String& operator+=(char c) { _s += c; return *this; }
+  String& operator+=(const char* s) { _s += s; return *this; }
+  const char* c_str() const { return _s.c_str(); }
+  unsigned int length() const { return (unsigned int)_s.size(); }
+private:
+  std::string _s;
+};
+
+// ===== Print / Stream =====
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t k = 0;
+    while (k < n && write(buf[k])) k++;
+    return k;
+  }
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+
+  size_t print(const __FlashStringHelper* s) { return write((const char*)s); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t print(const char s[]) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(long v, int base = DEC);
+  size_t print(unsigned long v, int base = DEC);
+  size_t print(double v, int digits = 2);
+
+  template <typename T>
+  size_t println(T v) { size_t n = print(v); return n + println(); }
+  size_t println() { return write("\r\n"); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual void flush() = 0;
+};
+
+#endif // HOST_ARDUINO_H
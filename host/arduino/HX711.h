@@ -0,0 +1,26 @@
+#ifndef HOST_HX711_H
+#define HOST_HX711_H
+
+#include <Arduino.h>
+
+// 호스트 빌드용 HX711 대체: 로드셀 값은 hostSetAnalog(dout 핀) 으로 주입
+class HX711 {
+public:
+  void begin(uint8_t dout, uint8_t sck, uint8_t gain = 128) { _dout = dout; (void)sck; (void)gain; }
+  bool is_ready() { return true; }
+  bool wait_ready_timeout(unsigned long timeout = 1000, unsigned long delay_ms = 0) {
+    (void)timeout; (void)delay_ms;
+    return true;
+  }
+  void set_scale(float scale = 1.f) { _scale = scale; }
+  void tare(uint8_t times = 10) { (void)times; _offset = analogRead(_dout); }
+  long read() { return analogRead(_dout); }
+  float get_units(uint8_t times = 1) { (void)times; return (read() - _offset) / _scale; }
+
+private:
+  uint8_t _dout = 0;
+  float _scale = 1.f;
+  long _offset = 0;
+};
+
+#endif // HOST_HX711_H
@@ -0,0 +1,224 @@
+// =======================================================
+// === 펌웨어 호스트 실행기
+// =======================================================
+// 스케치(setup/loop)를 리눅스에서 그대로 돌리고, Link 를 PTY / TCP /
+// 유닉스 소켓 / 표준입출력 중 하나에 붙인다. 실물 보드 없이 호스트
+// 소프트웨어와 프로토콜을 끝까지(end-to-end) 시험하기 위한 용도.
+//
+//   botty_host --pty [링크경로]   PTY 생성 (경로를 주면 슬레이브에 심볼릭 링크)
+//   botty_host --tcp 포트         127.0.0.1:포트 에서 접속 대기
+//   botty_host --unix 경로        유닉스 소켓에서 접속 대기
+//   botty_host --stdio            표준입력/표준출력
+
+#include <Arduino.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+void setup();
+void loop();
+
+// 파일 디스크립터 위의 Stream. 소켓 모드에서는 접속이 끊기면 다음 접속을 받는다.
+class FdStream : public Stream {
+public:
+  void attach(int rfd, int wfd) { _rfd = rfd; _wfd = wfd; }
+  void listenOn(int lfd) { _lfd = lfd; }
+  void exitOnEof() { _exitOnEof = true; }
+
+  int available() override {
+    fill();
+    return (int)(_tail - _head);
+  }
+  int read() override {
+    fill();
+    return (_head < _tail) ? (uint8_t)_buf[_head++] : -1;
+  }
+  int peek() override {
+    fill();
+    return (_head < _tail) ? (uint8_t)_buf[_head] : -1;
+  }
+  void flush() override {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t n) override {
+    size_t done = 0;
+    if (_wfd < 0) return 0;  // 접속 전: 버림 (UART 와 동일하게 수신자 없으면 유실)
+    while (done < n) {
+      ssize_t k = ::write(_wfd, buf + done, n - done);
+      if (k > 0) {
+        done += (size_t)k;
+      } else if (k < 0 && (errno == EAGAIN || errno == EINTR)) {
+        struct pollfd p = { _wfd, POLLOUT, 0 };
+        poll(&p, 1, 10);
+      } else {
+        disconnect();
+        break;
+      }
+    }
+    return done;
+  }
+  using Print::write;
+
+  // 입력이 올 때까지 최대 timeoutUs 대기 (loop 공회전 시 CPU 점유 방지,
+  // 스케줄러 틱(1ms) 보다 충분히 짧게)
+  void idle(long timeoutUs) {
+    struct pollfd p = { _rfd >= 0 ? _rfd : _lfd, POLLIN, 0 };
+    struct timespec ts = { 0, timeoutUs * 1000 };
+    if (p.fd >= 0) ppoll(&p, 1, &ts, nullptr);
+    else nanosleep(&ts, nullptr);
+  }
+
+private:
+  void fill() {
+    if (_rfd < 0) accept();
+    if (_rfd < 0) return;
+    if (_head == _tail) _head = _tail = 0;
+    if (_tail >= sizeof(_buf)) return;
+
+    ssize_t k = ::read(_rfd, _buf + _tail, sizeof(_buf) - _tail);
+    if (k > 0) {
+      _tail += (size_t)k;
+    } else if (k == 0 || (errno != EAGAIN && errno != EINTR && errno != EIO)) {
+      disconnect();
+    }
+  }
+
+  void accept() {
+    if (_lfd < 0) return;
+    int fd = ::accept(_lfd, nullptr, nullptr);
+    if (fd < 0) return;
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    _rfd = _wfd = fd;
+    fprintf(stderr, "botty_host: client connected\n");
+  }
+
+  void disconnect() {
+    if (_exitOnEof) exit(0);  // stdio: 상위 프로세스(게이트웨이 등)가 끝나면 함께 종료
+    if (_lfd < 0) return;  // PTY 는 유지
+    if (_rfd >= 0) close(_rfd);
+    _rfd = _wfd = -1;
+    _head = _tail = 0;
+    fprintf(stderr, "botty_host: client disconnected\n");
+  }
+
+  int _rfd = -1;
+  int _wfd = -1;
+  int _lfd = -1;
+  bool _exitOnEof = false;
+  char _buf[1024];
+  size_t _head = 0;
+  size_t _tail = 0;
+};
+
+static FdStream hostLink;
+
+Stream* hostTransportStream() { return &hostLink; }
+
+static bool openPty(const char* linkPath) {
+  int m = posix_openpt(O_RDWR | O_NOCTTY);
+  if (m < 0 || grantpt(m) < 0 || unlockpt(m) < 0) {
+    perror("botty_host: pty");
+    return false;
+  }
+  const char* slave = ptsname(m);
+
+  // 슬레이브를 raw 로 설정하고 열어둔다 (클라이언트가 닫아도 마스터가 EIO 로 끊기지 않도록)
+  int s = open(slave, O_RDWR | O_NOCTTY);
+  if (s < 0) {
+    perror("botty_host: pty slave");
+    return false;
+  }
+  struct termios t;
+  tcgetattr(s, &t);
+  cfmakeraw(&t);
+  tcsetattr(s, TCSANOW, &t);
+
+  fcntl(m, F_SETFL, O_NONBLOCK);
+  hostLink.attach(m, m);
+
+  if (linkPath) {
+    unlink(linkPath);
+    if (symlink(slave, linkPath) < 0) perror("botty_host: symlink");
+  }
+  fprintf(stderr, "botty_host: pty %s%s%s\n", slave, linkPath ? " -> " : "", linkPath ? linkPath : "");
+  return true;
+}
+
+static bool listenTcp(int port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  int on = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+  struct sockaddr_in a;
+  memset(&a, 0, sizeof(a));
+  a.sin_family = AF_INET;
+  a.sin_port = htons((uint16_t)port);
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(fd, (struct sockaddr*)&a, sizeof(a)) < 0 || listen(fd, 1) < 0) {
+    perror("botty_host: tcp");
+    return false;
+  }
+  fcntl(fd, F_SETFL, O_NONBLOCK);
+  hostLink.listenOn(fd);
+  fprintf(stderr, "botty_host: listening on 127.0.0.1:%d\n", port);
+  return true;
+}
+
+static bool listenUnix(const char* path) {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un a;
+  memset(&a, 0, sizeof(a));
+  a.sun_family = AF_UNIX;
+  strncpy(a.sun_path, path, sizeof(a.sun_path) - 1);
+  unlink(path);
+  if (bind(fd, (struct sockaddr*)&a, sizeof(a)) < 0 || listen(fd, 1) < 0) {
+    perror("botty_host: unix");
+    return false;
+  }
+  fcntl(fd, F_SETFL, O_NONBLOCK);
+  hostLink.listenOn(fd);
+  fprintf(stderr, "botty_host: listening on %s\n", path);
+  return true;
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: botty_host --pty [link] | --tcp port | --unix path | --stdio\n");
+}
+
+int main(int argc, char** argv) {
+  bool ok = false;
+
+  if (argc >= 2 && strcmp(argv[1], "--pty") == 0) {
+    ok = openPty(argc >= 3 ? argv[2] : nullptr);
+  } else if (argc >= 3 && strcmp(argv[1], "--tcp") == 0) {
+    ok = listenTcp(atoi(argv[2]));
+  } else if (argc >= 3 && strcmp(argv[1], "--unix") == 0) {
+    ok = listenUnix(argv[2]);
+  } else if (argc >= 2 && strcmp(argv[1], "--stdio") == 0) {
+    fcntl(STDIN_FILENO, F_SETFL, O_NONBLOCK);
+    hostLink.attach(STDIN_FILENO, STDOUT_FILENO);
+    hostLink.exitOnEof();
+    ok = true;
+  } else {
+    usage();
+    return 2;
+  }
+  if (!ok) return 1;
+
+  setup();
+  for (;;) {
+    loop();
+    hostLink.idle(200);
+  }
+}
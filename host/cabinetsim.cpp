@@ -0,0 +1,927 @@
+// =======================================================
+// === 캐비닛 처리량 시뮬레이터 (이산 사건, 가상 시각)
+// =======================================================
+// 보드마다 실제 펌웨어(build/botty_sim.so 복사본)를 띄우고, 모터 출력에 따라
+// 센서 입력을 바꾸는 구동부 모델(용기 회전, 면 상승 / 배출 슬라이드, 스프 오거 부하,
+// 배출구 문, HX711 무게)을 붙여 가상 시각 1ms 틱으로 함께 돌린다.
+// 주문은 호스트처럼 JSON 명령을 보내고 이벤트 / 텔레메트리로 다음 단계로 넘어간다.
+//
+//   주문 1건: 조리기 확보 -> 면(상승, 배출) + 스프(정량) -> 조리(급수, 가열)
+//             -> (조리 시작과 함께) 용기 배출 -> 배출구 확보, 옮김 -> 그릇 놓임
+//             -> (펌웨어가 무게로 감지해 문 열기) 손님 수령 -> (펌웨어가 문 닫기, "free")
+//
+//   cabinetsim [옵션]
+//     --cup N --ramen N --powder N --cooker N --outlet N   유닛 수 (기본 2 4 4 4 2,
+//                              보드 최대치를 넘으면 보드를 나눈다)
+//     --trace 파일             주문 도착 기록: 줄마다 "도착초 [스프mg] [물ml] [조리초]"
+//     --rate N --hours H       trace 가 없을 때 시간당 N 건 포아송 도착, H 시간 (기본 60, 1)
+//     --seed N                 포아송 난수 시드
+//     --set 키=값              구동부 / 흐름 시간 파라미터 (반복 가능)
+//     --params 파일            키=값 줄 모음 (# 주석)
+//     --orders 파일            주문별 단계 시각 CSV
+//     --list-params            파라미터와 기본값 출력
+//     --so 경로                펌웨어 라이브러리 (기본: 실행 파일 옆 botty_sim.so)
+//
+// 결과: 시간당 그릇 수, 단계(장비)별 가동률 / 대기(큐잉) 지연 / 처리 시간,
+//       주문 지연(도착 -> 문 열림) 분포, 배출구 대기(pickup 이벤트의 dwell),
+//       펌웨어 에러 / 마감 초과 수.
+//
+// 펌웨어의 micros() 는 Due 처럼 32비트라 가상 시각 약 71.6분마다 넘어간다.
+// 교대 근무 길이(--hours 8~12)로 돌리면 그 wrap 을 여러 번 지나므로, 스케줄러 /
+// 타임아웃 계산이 wrap 을 넘어서도 맞는지 함께 확인된다.
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "config.h"     // 펌웨어 핀맵 (보드 모델이 같은 핀을 읽고 쓴다)
+#include "jsonflat.h"
+#include "logrecord.h"
+#include "simboard.h"
+
+static const unsigned long STEP_US = 1000;            // 스케줄러 틱과 같은 1ms
+static const unsigned long long WARMUP_US = 1000000;  // setting 적용 후 첫 주문까지
+
+// =======================================================
+// === 파라미터
+// =======================================================
+
+struct Param {
+  const char* key;
+  double value;
+  const char* help;
+};
+
+static Param params[] = {
+  { "cup.rotate_ms",      800,   "용기 1개 배출 회전 시간 (펌웨어 최소 500ms)" },
+  { "cup.stock",          200,   "용기 유닛당 재고" },
+  { "ramen.rise_ms",      2500,  "면 한 덩이 올라오는 상승 시간" },
+  { "ramen.eject_ms",     1200,  "배출 슬라이드 전진 시간" },
+  { "ramen.return_ms",    1200,  "배출 슬라이드 복귀 시간" },
+  { "ramen.stock",        40,    "면 레인당 재고" },
+  { "powder.mg",          12000, "주문당 스프 목표량 (trace 에 없을 때)" },
+  { "powder.rate_mg_s",   1500,  "실제 오거 유량 (펌웨어 모델과 다르면 배출 오차)" },
+  { "powder.load",        200,   "배출 중 오거 부하 전류 (ADC)" },
+  { "cooker.water_ml",    550,   "주문당 급수량 (trace 에 없을 때)" },
+  { "cooker.cook_s",      210,   "주문당 가열 시간 (trace 에 없을 때)" },
+  { "cooker.load",        300,   "가열 중 전류 (ADC)" },
+  { "transfer.ms",        4000,  "조리기 -> 그릇 -> 배출구로 옮기는 시간" },
+  { "outlet.door_ms",     1500,  "배출구 문 열림 / 닫힘 시간" },
+  { "outlet.bowl_g",      650,   "완성 그릇 무게 (HX711)" },
+  { "outlet.pickup_s",    25,    "문이 열린 뒤 손님이 가져가기까지" },
+};
+
+static Param* findParam(const char* key) {
+  for (Param& p : params) {
+    if (strcmp(p.key, key) == 0) return &p;
+  }
+  return nullptr;
+}
+
+static double param(const char* key) {
+  Param* p = findParam(key);
+  if (!p) {
+    fprintf(stderr, "cabinetsim: unknown parameter %s\n", key);
+    exit(2);
+  }
+  return p->value;
+}
+
+static bool setParam(const std::string& kv) {
+  size_t eq = kv.find('=');
+  if (eq == std::string::npos) return false;
+  Param* p = findParam(kv.substr(0, eq).c_str());
+  if (!p) return false;
+  p->value = atof(kv.c_str() + eq + 1);
+  return true;
+}
+
+static bool loadParams(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  char line[256];
+  bool ok = true;
+  while (fgets(line, sizeof(line), f)) {
+    std::string s(line);
+    s.erase(std::find(s.begin(), s.end(), '#'), s.end());
+    s.erase(std::remove_if(s.begin(), s.end(), [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }), s.end());
+    if (s.empty()) continue;
+    if (!setParam(s)) {
+      fprintf(stderr, "cabinetsim: bad parameter line: %s\n", s.c_str());
+      ok = false;
+    }
+  }
+  fclose(f);
+  return ok;
+}
+
+// 실행 중에 쓰는 값 (µs)
+struct Timing {
+  unsigned long long cupRotateUs;
+  long cupStock;
+  unsigned long long riseUs, ejectUs, returnUs;
+  long ramenStock;
+  double powderRate;
+  int powderLoad;
+  int cookerLoad;
+  unsigned long long transferUs, doorUs, pickupUs;
+  int bowlG;
+};
+
+static Timing T;
+
+static void loadTiming() {
+  T.cupRotateUs = (unsigned long long)(param("cup.rotate_ms") * 1000);
+  T.cupStock = (long)param("cup.stock");
+  T.riseUs = (unsigned long long)(param("ramen.rise_ms") * 1000);
+  T.ejectUs = (unsigned long long)(param("ramen.eject_ms") * 1000);
+  T.returnUs = (unsigned long long)(param("ramen.return_ms") * 1000);
+  T.ramenStock = (long)param("ramen.stock");
+  T.powderRate = param("powder.rate_mg_s");
+  T.powderLoad = (int)param("powder.load");
+  T.cookerLoad = (int)param("cooker.load");
+  T.transferUs = (unsigned long long)(param("transfer.ms") * 1000);
+  T.doorUs = (unsigned long long)(param("outlet.door_ms") * 1000);
+  T.pickupUs = (unsigned long long)(param("outlet.pickup_s") * 1e6);
+  T.bowlG = (int)param("outlet.bowl_g");
+}
+
+// =======================================================
+// === 보드 (펌웨어 복사본) 와 구동부 모델
+// =======================================================
+
+enum Kind { K_CUP, K_RAMEN, K_POWDER, K_COOKER, K_OUTLET, KIND_COUNT };
+static const char* const KIND_NAME[KIND_COUNT] = { "cup", "ramen", "powder", "cooker", "outlet" };
+// 보드 하나가 구동할 수 있는 유닛 수 (조리기는 배선된 것만)
+static const uint8_t KIND_MAX[KIND_COUNT] = { MAX_CUP, MAX_RAMEN, MAX_POWDER, COOKER_WIRED, MAX_OUTLET };
+
+static Kind kindOf(const std::string& name) {
+  for (int k = 0; k < KIND_COUNT; k++) {
+    if (name == KIND_NAME[k]) return (Kind)k;
+  }
+  return KIND_COUNT;
+}
+
+// 유닛 하나의 물리 상태
+struct UnitModel {
+  int prevOut = LOW;                // 직전 스텝의 주 출력 (상승 / 전진 / 모터)
+  unsigned long long since = 0;     // 주 출력이 켜진 시각
+  long stock = 0;
+  double pos = 0;                   // 슬라이드 / 문 위치 (0 원위치 ~ 1 끝)
+  unsigned long long liftLeftUs = 0;  // 다음 면 덩이가 센서에 닿기까지 남은 상승
+  bool present = false;             // 면 덩이가 상단 센서에 있음
+  double dosedMg = 0;               // 스프 실제 배출량 (이번 배출)
+  bool bowl = false;                // 배출구에 그릇 있음
+};
+
+struct Board {
+  Kind kind;
+  int units;
+  int firstUnit;                    // 전체 유닛 번호에서 control 1 의 번호
+  SimBoardApi api;
+  logrec::Splitter rx;
+  std::vector<std::string> lastState;  // control 별 마지막 텔레메트리 객체
+  std::vector<UnitModel> model;
+};
+
+static std::vector<Board> boards;
+
+static bool openBoard(const char* soPath, SimBoardApi& api) {
+  // 같은 파일을 두 번 dlopen 하면 한 번만 올라오므로 보드마다 복사본을 연다
+  char tmp[] = "/tmp/cabinetsim-XXXXXX";
+  int out = mkstemp(tmp);
+  int in = open(soPath, O_RDONLY);
+  if (out < 0 || in < 0) {
+    perror("cabinetsim: firmware copy");
+    return false;
+  }
+  char buf[65536];
+  ssize_t k;
+  while ((k = read(in, buf, sizeof(buf))) > 0) {
+    if (write(out, buf, (size_t)k) != k) break;
+  }
+  close(in);
+  close(out);
+
+  void* h = dlopen(tmp, RTLD_NOW | RTLD_LOCAL);
+  unlink(tmp);
+  if (!h) {
+    fprintf(stderr, "cabinetsim: %s\n", dlerror());
+    return false;
+  }
+  api.boot = (void (*)())dlsym(h, "simBoot");
+  api.step = (void (*)(unsigned long))dlsym(h, "simStep");
+  api.send = (void (*)(const char*))dlsym(h, "simSend");
+  api.take = (size_t (*)(uint8_t*, size_t))dlsym(h, "simTake");
+  api.read = (int (*)(uint8_t))dlsym(h, "simRead");
+  api.write = (void (*)(uint8_t, int))dlsym(h, "simWrite");
+  api.analog = (void (*)(uint8_t, int))dlsym(h, "simAnalog");
+  return api.boot && api.step && api.send && api.take && api.read && api.write && api.analog;
+}
+
+// 보드 전원 직후 센서 초기 상태 (원위치, 재고 있음)
+static void initModel(Board& b) {
+  b.model.assign(b.units, UnitModel());
+  b.lastState.assign(b.units, std::string());
+  for (int i = 0; i < b.units; i++) {
+    UnitModel& m = b.model[i];
+    switch (b.kind) {
+      case K_CUP:
+        m.stock = T.cupStock;
+        b.api.write(CUP_DISP_IN[i], LOW);
+        b.api.write(CUP_STOCK_IN[i], m.stock > 0 ? !CUP_STOCK_EMPTY_LEVEL : CUP_STOCK_EMPTY_LEVEL);
+        break;
+      case K_RAMEN:
+        m.stock = T.ramenStock;
+        m.liftLeftUs = T.riseUs;
+        b.api.write(RAMEN_PRESENT_IN[i], HIGH);  // 감지 시 LOW
+        b.api.write(RAMEN_EJ_BTM_IN[i], HIGH);
+        b.api.write(RAMEN_EJ_TOP_IN[i], LOW);
+        b.api.write(RAMEN_UP_TOP_IN[i], LOW);
+        break;
+      case K_OUTLET:
+        b.api.write(OUTLET_CLOSE_IN[i], HIGH);
+        b.api.write(OUTLET_OPEN_IN[i], LOW);
+        b.api.analog(OUTLET_LOAD_AIN[i], 0);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+// 위치 pos 를 dir(+1 / -1) 방향으로 한 스텝 옮기고 양 끝 리밋 입력을 갱신
+static void moveAxis(Board& b, double& pos, int dir, unsigned long long travelUs,
+                     uint8_t homeIn, uint8_t endIn) {
+  double prev = pos;
+  pos += dir * (travelUs ? (double)STEP_US / travelUs : 1.0);
+  if (pos > 1) pos = 1;
+  if (pos < 0) pos = 0;
+  if (prev == 0 && pos > 0) b.api.write(homeIn, LOW);
+  if (prev == 1 && pos < 1) b.api.write(endIn, LOW);
+  if (pos == 1 && prev < 1) b.api.write(endIn, HIGH);
+  if (pos == 0 && prev > 0) b.api.write(homeIn, HIGH);
+}
+
+// 출력 핀을 보고 한 스텝(1ms) 만큼 구동부를 움직인다
+static void stepModel(Board& b, unsigned long long now) {
+  for (int i = 0; i < b.units; i++) {
+    UnitModel& m = b.model[i];
+    switch (b.kind) {
+      case K_CUP: {
+        int out = b.api.read(CUP_MOTOR_OUT[i]);
+        if (out && !m.prevOut) {
+          m.since = now;
+          b.api.write(CUP_DISP_IN[i], HIGH);  // 회전 중 (배출 감지 해제)
+        } else if (out && now - m.since >= T.cupRotateUs && b.api.read(CUP_DISP_IN[i]) == HIGH) {
+          b.api.write(CUP_DISP_IN[i], LOW);   // 1개 떨어짐
+          if (m.stock > 0 && --m.stock == 0) b.api.write(CUP_STOCK_IN[i], CUP_STOCK_EMPTY_LEVEL);
+        }
+        m.prevOut = out;
+        break;
+      }
+      case K_RAMEN: {
+        if (b.api.read(RAMEN_UP_FWD_OUT[i])) {
+          if (m.liftLeftUs > STEP_US) {
+            m.liftLeftUs -= STEP_US;
+          } else if (m.stock > 0) {
+            if (!m.present) b.api.write(RAMEN_PRESENT_IN[i], LOW);
+            m.present = true;
+          } else {
+            b.api.write(RAMEN_UP_TOP_IN[i], HIGH);  // 빈 레인: 상한까지 올라감
+          }
+        }
+        if (b.api.read(RAMEN_EJ_FWD_OUT[i])) {
+          moveAxis(b, m.pos, +1, T.ejectUs, RAMEN_EJ_BTM_IN[i], RAMEN_EJ_TOP_IN[i]);
+          if (m.pos == 1 && m.present) {  // 덩이를 밀어냄
+            m.present = false;
+            m.stock--;
+            m.liftLeftUs = T.riseUs;
+            b.api.write(RAMEN_PRESENT_IN[i], HIGH);
+          }
+        } else if (b.api.read(RAMEN_EJ_REV_OUT[i])) {
+          moveAxis(b, m.pos, -1, T.returnUs, RAMEN_EJ_BTM_IN[i], RAMEN_EJ_TOP_IN[i]);
+        }
+        break;
+      }
+      case K_POWDER: {
+        int out = b.api.read(POWDER_MOTOR_OUT[i]);
+        if (out && !m.prevOut) m.dosedMg = 0;
+        if (out) m.dosedMg += T.powderRate * STEP_US / 1e6;
+        if (out != m.prevOut) b.api.analog(POWDER_CURR_AIN[i], out ? T.powderLoad : 0);
+        m.prevOut = out;
+        break;
+      }
+      case K_COOKER: {
+        int out = b.api.read(COOKER_IND_SIG[i]);
+        if (out != m.prevOut) b.api.analog(COOKER_CURR_AIN[i], out ? T.cookerLoad : 0);
+        m.prevOut = out;
+        break;
+      }
+      case K_OUTLET: {
+        if (b.api.read(OUTLET_FWD_OUT[i])) {
+          moveAxis(b, m.pos, +1, T.doorUs, OUTLET_CLOSE_IN[i], OUTLET_OPEN_IN[i]);
+        } else if (b.api.read(OUTLET_REV_OUT[i])) {
+          moveAxis(b, m.pos, -1, T.doorUs, OUTLET_CLOSE_IN[i], OUTLET_OPEN_IN[i]);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+static void setBowl(Board& b, int control, bool on) {
+  b.model[control - 1].bowl = on;
+  b.api.analog(OUTLET_LOAD_AIN[control - 1], on ? T.bowlG * 10 : 0);  // 펌웨어 set_scale(10)
+}
+
+// =======================================================
+// === 주문과 자원 (단계별 유닛)
+// =======================================================
+
+enum OutletPhase { OUT_NONE, OUT_TRANSFER, OUT_OPENING, OUT_PICKUP, OUT_CLOSING, OUT_DONE };
+
+struct Order {
+  int id = 0;
+  unsigned long long arriveUs = 0;
+  long powderMg = 0, waterMl = 0, cookS = 0;
+
+  int unit[KIND_COUNT] = { -1, -1, -1, -1, -1 };
+  unsigned long long readyUs[KIND_COUNT] = {};  // 단계에 줄 선 시각
+  unsigned long long waitUs[KIND_COUNT] = {};   // 단계 대기 누계 (빈 레인으로 다시 줄 선 경우 포함)
+  unsigned long long startUs[KIND_COUNT] = {};  // 유닛 배정
+  unsigned long long endUs[KIND_COUNT] = {};    // 유닛 반납
+
+  bool ramenRising = false;
+  bool ramenDone = false, powderDone = false, cookStarted = false, cookDone = false;
+  bool cupQueued = false, cupDone = false, outletQueued = false;
+  OutletPhase out = OUT_NONE;
+  unsigned long long phaseUntil = 0;
+  unsigned long long deliveredUs = 0;
+  bool failed = false;
+  double dosedMg = 0;
+};
+
+struct Resource {
+  std::vector<int> holder;        // 유닛별 주문 번호 (-1 비어 있음)
+  std::vector<bool> empty;        // 재고 없음으로 제외
+  std::vector<unsigned long long> since;
+  std::deque<int> waiting;
+  unsigned long long busyUs = 0;
+  long jobs = 0;
+  double waitSumUs = 0, serviceSumUs = 0;
+  unsigned long long waitMaxUs = 0;
+};
+
+static std::vector<Order> orders;
+static Resource res[KIND_COUNT];
+static long firmwareErrors = 0, firmwareFaults = 0, lanesEmptied = 0;
+static long pickups = 0;
+static double dwellSumMs = 0, dwellMaxMs = 0;  // 펌웨어 pickup 이벤트 (놓임 -> 가져감)
+
+// 전체 유닛 번호 -> (보드, control)
+static Board& boardOf(Kind k, int unit, int& control) {
+  for (Board& b : boards) {
+    if (b.kind == k && unit >= b.firstUnit && unit < b.firstUnit + b.units) {
+      control = unit - b.firstUnit + 1;
+      return b;
+    }
+  }
+  fprintf(stderr, "cabinetsim: no board for %s unit %d\n", KIND_NAME[k], unit);
+  exit(1);
+}
+
+static void command(Kind k, int unit, const std::string& fields) {
+  int control;
+  Board& b = boardOf(k, unit, control);
+  std::string line = "[{\"device\":\"" + std::string(KIND_NAME[k]) + "\",\"control\":" +
+                     std::to_string(control) + "," + fields + "}]";
+  b.api.send(line.c_str());
+}
+
+static void enqueue(Kind k, Order& o, unsigned long long now, bool front = false) {
+  o.readyUs[k] = now;
+  if (front) res[k].waiting.push_front(o.id);
+  else res[k].waiting.push_back(o.id);
+}
+
+static void release(Kind k, int unit, unsigned long long now) {
+  Resource& r = res[k];
+  int id = r.holder[unit];
+  if (id < 0) return;
+  r.busyUs += now - r.since[unit];
+  r.serviceSumUs += now - r.since[unit];
+  r.holder[unit] = -1;
+  orders[id].endUs[k] = now;
+}
+
+// 단계 시작: 유닛이 배정되면 해당 장비에 명령
+static void startStage(Kind k, Order& o, unsigned long long now) {
+  switch (k) {
+    case K_COOKER:
+      enqueue(K_RAMEN, o, now);
+      enqueue(K_POWDER, o, now);
+      break;
+    case K_RAMEN:
+      o.ramenRising = true;
+      command(K_RAMEN, o.unit[k], "\"function\":\"readydispense\"");
+      break;
+    case K_POWDER:
+      command(K_POWDER, o.unit[k], "\"function\":\"dose\",\"dose\":" + std::to_string(o.powderMg));
+      break;
+    case K_CUP:
+      command(K_CUP, o.unit[k], "\"function\":\"startdispense\",\"count\":1");
+      break;
+    case K_OUTLET:
+      release(K_COOKER, o.unit[K_COOKER], now);  // 조리기에서 꺼내 옮기기 시작
+      o.out = OUT_TRANSFER;
+      o.phaseUntil = now + T.transferUs;
+      break;
+    default:
+      break;
+  }
+}
+
+// 주문 실패: 모든 단계 대기에서 빼고 조리기는 멈춰 내놓는다.
+// 동작 중인 면 / 스프 / 용기 유닛은 완료 이벤트가 올 때 반납된다.
+static void failOrder(Order& o, unsigned long long now) {
+  o.failed = true;
+  for (int k = 0; k < KIND_COUNT; k++) {
+    Resource& r = res[k];
+    r.waiting.erase(std::remove(r.waiting.begin(), r.waiting.end(), o.id), r.waiting.end());
+  }
+  int c = o.unit[K_COOKER];
+  if (c >= 0 && res[K_COOKER].holder[c] == o.id) {
+    if (o.cookStarted && !o.cookDone) command(K_COOKER, c, "\"function\":\"stopcook\"");
+    release(K_COOKER, c, now);
+  }
+}
+
+// 이 단계에 쓸 수 있는 유닛이 하나도 없으면 대기 주문은 실패 처리
+static void failIfExhausted(Kind k, unsigned long long now) {
+  Resource& r = res[k];
+  if (std::find(r.empty.begin(), r.empty.end(), false) != r.empty.end()) return;
+  while (!r.waiting.empty()) failOrder(orders[r.waiting.front()], now);
+}
+
+// 대기 중인 주문에 빈 유닛 배정 (FIFO)
+static void dispatch(unsigned long long now) {
+  for (int k = 0; k < KIND_COUNT; k++) {
+    Resource& r = res[k];
+    failIfExhausted((Kind)k, now);
+    while (!r.waiting.empty()) {
+      int u = -1;
+      for (size_t i = 0; i < r.holder.size(); i++) {
+        if (r.holder[i] < 0 && !r.empty[i]) { u = (int)i; break; }
+      }
+      if (u < 0) break;
+
+      Order& o = orders[r.waiting.front()];
+      r.waiting.pop_front();
+      unsigned long long wait = now - o.readyUs[k];
+      o.waitUs[k] += wait;
+      r.waitSumUs += wait;
+      if (wait > r.waitMaxUs) r.waitMaxUs = wait;
+      r.jobs++;
+      r.holder[u] = o.id;
+      r.since[u] = now;
+      o.unit[k] = u;
+      o.startUs[k] = now;
+      startStage((Kind)k, o, now);
+    }
+  }
+}
+
+static void advance(Order& o, unsigned long long now) {
+  if (o.failed) return;
+  if (!o.cookStarted && o.ramenDone && o.powderDone) {
+    o.cookStarted = true;
+    command(K_COOKER, o.unit[K_COOKER], "\"function\":\"startcook\",\"water\":" +
+            std::to_string(o.waterMl) + ",\"timer\":" + std::to_string(o.cookS));
+    enqueue(K_CUP, o, now);  // 조리하는 동안 그릇 준비
+    o.cupQueued = true;
+  }
+  if (!o.outletQueued && o.cookDone && o.cupDone) {
+    o.outletQueued = true;
+    enqueue(K_OUTLET, o, now);
+  }
+}
+
+// 보드에서 온 이벤트 / 에러 / 텔레메트리
+static void handleObject(Board& b, const std::string& obj, unsigned long long now) {
+  std::string dev, ctl, event, tmp;
+  if (!jsonflat::findValue(obj, "device", dev)) return;
+  if (jsonflat::findValue(obj, "error", tmp)) {
+    firmwareErrors++;
+    fprintf(stderr, "[%9.3f] %s error: %s\n", now / 1e6, KIND_NAME[b.kind], obj.c_str());
+    return;
+  }
+  if (jsonflat::findValue(obj, "fault", tmp)) {
+    firmwareFaults++;
+    fprintf(stderr, "[%9.3f] %s fault: %s\n", now / 1e6, KIND_NAME[b.kind], obj.c_str());
+    return;
+  }
+  Kind k = kindOf(dev);
+  if (k != b.kind || !jsonflat::findValue(obj, "control", ctl)) return;
+  int control = atoi(ctl.c_str());
+  if (control < 1 || control > b.units) return;
+  int unit = b.firstUnit + control - 1;
+  int id = res[k].holder[unit];
+
+  if (!jsonflat::findValue(obj, "event", event)) {
+    b.lastState[control - 1] = obj;
+    return;
+  }
+  if (id < 0) return;
+  Order& o = orders[id];
+
+  if (k == K_CUP && event == "dispensed") {
+    release(K_CUP, unit, now);
+    o.cupDone = true;
+  } else if (k == K_CUP && event == "stockout") {
+    release(K_CUP, unit, now);
+    res[K_CUP].empty[unit] = true;
+    if (!o.failed) enqueue(K_CUP, o, now, true);
+    failIfExhausted(K_CUP, now);
+  } else if (k == K_RAMEN && event == "ejected") {
+    release(K_RAMEN, unit, now);
+    o.ramenDone = true;
+  } else if (k == K_POWDER && (event == "dosed" || event == "doseshort")) {
+    o.dosedMg = b.model[control - 1].dosedMg;
+    release(K_POWDER, unit, now);
+    o.powderDone = true;
+  } else if (k == K_COOKER && event == "done") {
+    o.cookDone = true;
+  } else if (k == K_OUTLET && event == "pickup") {
+    double dwell = jsonflat::findValue(obj, "dwell", tmp) ? atof(tmp.c_str()) : 0;
+    pickups++;
+    dwellSumMs += dwell;
+    if (dwell > dwellMaxMs) dwellMaxMs = dwell;
+  } else if (k == K_OUTLET && event == "free" && o.out == OUT_CLOSING) {
+    o.out = OUT_DONE;
+    release(K_OUTLET, unit, now);
+  }
+  advance(o, now);
+}
+
+static bool stateIs(const Board& b, int control, const char* key, const char* value) {
+  std::string v;
+  return jsonflat::findValue(b.lastState[control - 1], key, v) && v == value;
+}
+
+// 텔레메트리 / 시간으로 넘어가는 단계 (면 상승 완료, 배출구 문과 손님)
+static void pollOrders(unsigned long long now) {
+  for (int u = 0; u < (int)res[K_RAMEN].holder.size(); u++) {
+    int id = res[K_RAMEN].holder[u];
+    if (id < 0 || !orders[id].ramenRising) continue;
+    Order& o = orders[id];
+    int control;
+    Board& b = boardOf(K_RAMEN, u, control);
+    if (stateIs(b, control, "detect", "0")) {         // 덩이가 상단 센서에 닿음
+      o.ramenRising = false;
+      command(K_RAMEN, u, "\"function\":\"startdispense\"");
+    } else if (stateIs(b, control, "liftup", "1")) {  // 덩이 없이 상한: 빈 레인
+      o.ramenRising = false;
+      release(K_RAMEN, u, now);
+      res[K_RAMEN].empty[u] = true;
+      lanesEmptied++;
+      if (!o.failed) enqueue(K_RAMEN, o, now, true);
+      failIfExhausted(K_RAMEN, now);
+    }
+  }
+
+  for (int u = 0; u < (int)res[K_OUTLET].holder.size(); u++) {
+    int id = res[K_OUTLET].holder[u];
+    if (id < 0) continue;
+    Order& o = orders[id];
+    int control;
+    Board& b = boardOf(K_OUTLET, u, control);
+
+    // 문 여닫기는 펌웨어가 로드셀로 한다 (그릇 놓임 -> 열기, 가져감 -> 닫기 후 "free")
+    if (o.out == OUT_TRANSFER && now >= o.phaseUntil) {
+      o.out = OUT_OPENING;
+      b.lastState[control - 1].clear();  // 놓은 이후 프레임만 본다
+      setBowl(b, control, true);
+    } else if (o.out == OUT_OPENING && stateIs(b, control, "opendoor", "1") && stateIs(b, control, "amp", "0")) {
+      o.deliveredUs = now;
+      o.out = OUT_PICKUP;
+      o.phaseUntil = now + T.pickupUs;
+    } else if (o.out == OUT_PICKUP && now >= o.phaseUntil) {
+      setBowl(b, control, false);
+      o.out = OUT_CLOSING;
+    }
+  }
+}
+
+static void drainBoard(Board& b, unsigned long long now) {
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = b.api.take(buf, sizeof(buf))) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      b.rx.feed(buf[i],
+                [&](const std::string& line) {
+                  std::vector<std::string> objs;
+                  if (!jsonflat::splitFrame(line, objs)) return;
+                  for (const std::string& obj : objs) handleObject(b, obj, now);
+                },
+                [](const logrec::Record&) {});
+    }
+  }
+}
+
+// =======================================================
+// === 주문 도착 (trace / 포아송)
+// =======================================================
+
+static bool loadTrace(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    char* hash = strchr(line, '#');
+    if (hash) *hash = '\0';
+    double at;
+    long mg = -1, ml = -1, s = -1;
+    if (sscanf(line, "%lf %ld %ld %ld", &at, &mg, &ml, &s) < 1) continue;
+
+    Order o;
+    o.id = (int)orders.size();
+    o.arriveUs = WARMUP_US + (unsigned long long)(at * 1e6);
+    o.powderMg = mg >= 0 ? mg : (long)param("powder.mg");
+    o.waterMl = ml >= 0 ? ml : (long)param("cooker.water_ml");
+    o.cookS = s >= 0 ? s : (long)param("cooker.cook_s");
+    orders.push_back(o);
+  }
+  fclose(f);
+  std::stable_sort(orders.begin(), orders.end(),
+                   [](const Order& a, const Order& b) { return a.arriveUs < b.arriveUs; });
+  for (size_t i = 0; i < orders.size(); i++) orders[i].id = (int)i;
+  return true;
+}
+
+static void poissonOrders(double perHour, double hours, unsigned seed) {
+  std::mt19937_64 rng(seed);
+  std::exponential_distribution<double> gap(perHour / 3600.0);
+  double t = 0;
+  for (;;) {
+    t += gap(rng);
+    if (t >= hours * 3600.0) break;
+    Order o;
+    o.id = (int)orders.size();
+    o.arriveUs = WARMUP_US + (unsigned long long)(t * 1e6);
+    o.powderMg = (long)param("powder.mg");
+    o.waterMl = (long)param("cooker.water_ml");
+    o.cookS = (long)param("cooker.cook_s");
+    orders.push_back(o);
+  }
+}
+
+// =======================================================
+// === 결과
+// =======================================================
+
+static double percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  size_t i = (size_t)ceil(p * v.size());
+  return v[i ? i - 1 : 0];
+}
+
+static void report(unsigned long long endUs) {
+  std::vector<double> latency;
+  unsigned long long first = orders.empty() ? WARMUP_US : orders.front().arriveUs;
+  unsigned long long last = first;
+  long failed = 0;
+  double doseErrSum = 0;
+  long doses = 0;
+
+  for (const Order& o : orders) {
+    if (o.failed) failed++;
+    if (!o.deliveredUs) continue;
+    latency.push_back((o.deliveredUs - o.arriveUs) / 1e6);
+    if (o.deliveredUs > last) last = o.deliveredUs;
+    if (o.powderMg > 0) {
+      doseErrSum += fabs(o.dosedMg - o.powderMg) / o.powderMg;
+      doses++;
+    }
+  }
+
+  double spanH = (last - first) / 3.6e9;
+  printf("orders: %zu arrived, %zu delivered, %ld failed (sim %.1f s)\n",
+         orders.size(), latency.size(), failed, (endUs - WARMUP_US) / 1e6);
+  printf("throughput: %.1f bowls/hour (first arrival -> last bowl, %.2f h)\n",
+         spanH > 0 ? latency.size() / spanH : 0.0, spanH);
+  if (!latency.empty()) {
+    double sum = 0;
+    for (double l : latency) sum += l;
+    printf("latency (arrival -> outlet door open) s: mean %.1f  p50 %.1f  p95 %.1f  max %.1f\n",
+           sum / latency.size(), percentile(latency, 0.5), percentile(latency, 0.95),
+           percentile(latency, 1.0));
+  }
+  printf("\n%-7s %5s %6s %8s %12s %12s %12s\n",
+         "stage", "units", "jobs", "util%", "wait mean s", "wait max s", "service s");
+
+  double spanUs = (double)(endUs - first);
+  int busiest = -1;
+  double busiestUtil = -1;
+  for (int k = 0; k < KIND_COUNT; k++) {
+    const Resource& r = res[k];
+    if (r.holder.empty()) continue;
+    // 끝날 때까지 점유 중인 유닛도 가동 시간에 넣는다
+    unsigned long long busy = r.busyUs;
+    for (size_t u = 0; u < r.holder.size(); u++) {
+      if (r.holder[u] >= 0) busy += endUs - r.since[u];
+    }
+    double util = spanUs > 0 ? 100.0 * busy / (spanUs * r.holder.size()) : 0;
+    if (util > busiestUtil) { busiestUtil = util; busiest = k; }
+    printf("%-7s %5zu %6ld %8.1f %12.2f %12.2f %12.2f\n", KIND_NAME[k], r.holder.size(), r.jobs, util,
+           r.jobs ? r.waitSumUs / r.jobs / 1e6 : 0.0, r.waitMaxUs / 1e6,
+           r.jobs ? r.serviceSumUs / r.jobs / 1e6 : 0.0);
+  }
+  if (busiest >= 0) printf("\nbottleneck: %s (%.1f%% busy)\n", KIND_NAME[busiest], busiestUtil);
+  if (doses) printf("powder dose error: mean %.1f%% of target\n", 100.0 * doseErrSum / doses);
+  if (lanesEmptied) printf("ramen lanes emptied: %ld\n", lanesEmptied);
+  if (pickups) printf("outlet dwell (placed -> picked up) s: mean %.1f  max %.1f\n",
+                      dwellSumMs / pickups / 1e3, dwellMaxMs / 1e3);
+  printf("firmware errors: %ld, motion timeouts: %ld\n", firmwareErrors, firmwareFaults);
+}
+
+static bool writeOrdersCsv(const char* path) {
+  FILE* f = fopen(path, "w");
+  if (!f) return false;
+  fprintf(f, "id,arrive_s");
+  for (int k = 0; k < KIND_COUNT; k++) {
+    fprintf(f, ",%s_unit,%s_wait_s,%s_start_s,%s_end_s", KIND_NAME[k], KIND_NAME[k], KIND_NAME[k], KIND_NAME[k]);
+  }
+  fprintf(f, ",delivered_s,dosed_mg,failed\n");
+
+  auto sec = [](unsigned long long us) { return us ? (us - WARMUP_US) / 1e6 : -1.0; };
+  for (const Order& o : orders) {
+    fprintf(f, "%d,%.3f", o.id, sec(o.arriveUs));
+    for (int k = 0; k < KIND_COUNT; k++) {
+      bool started = o.startUs[k] != 0;
+      fprintf(f, ",%d,%.3f,%.3f,%.3f", started ? o.unit[k] + 1 : 0,
+              started ? o.waitUs[k] / 1e6 : -1.0, sec(o.startUs[k]), sec(o.endUs[k]));
+    }
+    fprintf(f, ",%.3f,%.0f,%d\n", sec(o.deliveredUs), o.dosedMg, o.failed ? 1 : 0);
+  }
+  fclose(f);
+  return true;
+}
+
+// =======================================================
+// === main
+// =======================================================
+
+static void usage() {
+  fprintf(stderr,
+          "usage: cabinetsim [--cup N] [--ramen N] [--powder N] [--cooker N] [--outlet N]\n"
+          "                  [--trace file | --rate N --hours H [--seed N]]\n"
+          "                  [--set key=value]... [--params file] [--orders out.csv]\n"
+          "                  [--so botty_sim.so] [--list-params]\n");
+}
+
+int main(int argc, char** argv) {
+  int units[KIND_COUNT] = { 2, 4, 4, 4, 2 };
+  const char* tracePath = nullptr;
+  const char* ordersPath = nullptr;
+  std::string soPath;
+  double rate = 60, hours = 1;
+  unsigned seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    bool hasArg = i + 1 < argc;
+    Kind k = a.size() > 2 ? kindOf(a.substr(2)) : KIND_COUNT;
+    if (k != KIND_COUNT && hasArg) {
+      units[k] = atoi(argv[++i]);
+    } else if (a == "--trace" && hasArg) {
+      tracePath = argv[++i];
+    } else if (a == "--rate" && hasArg) {
+      rate = atof(argv[++i]);
+    } else if (a == "--hours" && hasArg) {
+      hours = atof(argv[++i]);
+    } else if (a == "--seed" && hasArg) {
+      seed = (unsigned)atol(argv[++i]);
+    } else if (a == "--set" && hasArg) {
+      if (!setParam(argv[++i])) {
+        fprintf(stderr, "cabinetsim: bad --set %s (see --list-params)\n", argv[i]);
+        return 2;
+      }
+    } else if (a == "--params" && hasArg) {
+      if (!loadParams(argv[++i])) return 2;
+    } else if (a == "--orders" && hasArg) {
+      ordersPath = argv[++i];
+    } else if (a == "--so" && hasArg) {
+      soPath = argv[++i];
+    } else if (a == "--list-params") {
+      for (const Param& p : params) printf("%-18s %8g  %s\n", p.key, p.value, p.help);
+      return 0;
+    } else {
+      usage();
+      return 2;
+    }
+  }
+  for (int k = 0; k < KIND_COUNT; k++) {
+    if (units[k] <= 0) {
+      fprintf(stderr, "cabinetsim: every stage needs at least one %s unit\n", KIND_NAME[k]);
+      return 2;
+    }
+  }
+  loadTiming();
+
+  if (soPath.empty()) {
+    char exe[PATH_MAX];
+    ssize_t n = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (n > 0) {
+      exe[n] = '\0';
+      soPath = std::string(exe, strrchr(exe, '/') - exe) + "/botty_sim.so";
+    }
+  }
+
+  if (tracePath) {
+    if (!loadTrace(tracePath)) {
+      perror(tracePath);
+      return 1;
+    }
+  } else {
+    poissonOrders(rate, hours, seed);
+  }
+
+  unsetenv("BOTTY_STORE");  // 보정 모델은 보드 메모리에만 (실제 저장 파일을 건드리지 않음)
+
+  // 장비 종류마다 보드 최대치 단위로 보드를 나눠 띄운다
+  for (int k = 0; k < KIND_COUNT; k++) {
+    res[k].holder.assign(units[k], -1);
+    res[k].empty.assign(units[k], false);
+    res[k].since.assign(units[k], 0);
+    for (int first = 0; first < units[k]; first += KIND_MAX[k]) {
+      Board b;
+      b.kind = (Kind)k;
+      b.units = std::min(units[k] - first, (int)KIND_MAX[k]);
+      b.firstUnit = first;
+      if (!openBoard(soPath.c_str(), b.api)) return 1;
+      boards.push_back(b);
+    }
+  }
+  for (Board& b : boards) {
+    b.api.boot();
+    initModel(b);
+    std::string setting = "[{\"device\":\"setting\",\"" + std::string(KIND_NAME[b.kind]) + "\":" +
+                          std::to_string(b.units) + "}]";
+    b.api.send(setting.c_str());
+  }
+
+  size_t next = 0;
+  unsigned long long now = 0;
+  unsigned long long lastArrive = orders.empty() ? 0 : orders.back().arriveUs;
+  unsigned long long limitUs = lastArrive + 4ULL * 3600 * 1000000;  // 밀린 주문을 비우는 최대 시간
+
+  for (;;) {
+    while (next < orders.size() && orders[next].arriveUs <= now) {
+      enqueue(K_COOKER, orders[next], now);
+      next++;
+    }
+    dispatch(now);
+    pollOrders(now);
+
+    for (Board& b : boards) stepModel(b, now);
+    now += STEP_US;
+    for (Board& b : boards) {
+      b.api.step(STEP_US);
+      drainBoard(b, now);
+    }
+
+    if (next == orders.size()) {
+      bool busy = false;
+      for (const Order& o : orders) {
+        if (!o.failed && o.out != OUT_DONE) { busy = true; break; }
+      }
+      if (!busy) break;
+    }
+    if (now > limitUs) {
+      fprintf(stderr, "cabinetsim: stopped at %.0f s with orders still open\n", (now - WARMUP_US) / 1e6);
+      break;
+    }
+  }
+
+  report(now);
+  if (ordersPath && !writeOrdersCsv(ordersPath)) {
+    perror(ordersPath);
+    return 1;
+  }
+  return 0;
+}
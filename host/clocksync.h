@@ -0,0 +1,116 @@
+#ifndef HOST_CLOCKSYNC_H
+#define HOST_CLOCKSYNC_H
+
+// =======================================================
+// === 기기 시각 <-> 호스트 시각 추정 (ping/pong)
+// =======================================================
+// 호스트가 [{"device":"ping","seq":N}] 을 보내고 보드가 수신 시점의 기기 시각을
+// [{"device":"pong","seq":N,"ts":T}] 로 돌려준다. 왕복 중간 시각을 기기 시각 T 에
+// 대응시킨 표본을 모으고, 왕복 시간이 짧은(큐 지연이 적은) 표본들로
+//   호스트 = 기기 + offset + drift * (기기 - 기준)
+// 직선을 맞춘다. 모든 시각은 µs, 호스트 쪽은 CLOCK_MONOTONIC.
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <vector>
+
+class ClockSync {
+ public:
+  static const size_t MAX_SAMPLES = 32;
+  static const size_t MAX_PENDING = 8;
+
+  // 보낼 ping 의 seq 를 받고 송신 시각을 기록
+  long ping(long long hostUs) {
+    long seq = _nextSeq;
+    _nextSeq = _nextSeq >= 999999999 ? 1 : _nextSeq + 1;  // 펌웨어 정수 키 9자리
+    _pending[seq] = hostUs;
+    while (_pending.size() > MAX_PENDING) _pending.erase(_pending.begin());
+    return seq;
+  }
+
+  // pong 수신. 모르는 seq (늦게 온 응답 등) 는 무시
+  void pong(long seq, unsigned long long devUs, long long hostUs) {
+    auto it = _pending.find(seq);
+    if (it == _pending.end()) return;
+    long long sent = it->second;
+    _pending.erase(it);
+
+    // 기기 시각이 되돌아가면 재부팅: 이전 표본 폐기
+    if (!_samples.empty() && devUs < _samples.back().dev) reset();
+
+    Sample s;
+    s.dev = devUs;
+    s.host = sent + (hostUs - sent) / 2;
+    s.rtt = hostUs - sent;
+    _samples.push_back(s);
+    if (_samples.size() > MAX_SAMPLES) _samples.pop_front();
+    fit();
+  }
+
+  void reset() {
+    _samples.clear();
+    _pending.clear();
+    _valid = false;
+  }
+
+  bool valid() const { return _valid; }
+  size_t samples() const { return _samples.size(); }
+  long long minRttUs() const { return _minRtt; }
+  double driftPpm() const { return _drift * 1e6; }
+
+  // 가장 최근 표본 시점의 (호스트 - 기기) 차이
+  long long offsetUs() const {
+    return _valid ? toHost(_samples.back().dev) - (long long)_samples.back().dev : 0;
+  }
+
+  // 기기 시각 -> 호스트 단조 시각
+  long long toHost(unsigned long long devUs) const {
+    double x = (double)(long long)(devUs - _ref);
+    return (long long)devUs + (long long)(_offset + _drift * x);
+  }
+
+ private:
+  struct Sample {
+    unsigned long long dev;
+    long long host;
+    long long rtt;
+  };
+
+  void fit() {
+    _minRtt = _samples.front().rtt;
+    for (const Sample& s : _samples) _minRtt = std::min(_minRtt, s.rtt);
+
+    // 왕복 시간이 최소값 근처인 표본만 (큐 지연이 섞인 표본 제외)
+    long long limit = _minRtt + std::max(_minRtt / 2, 500LL);
+    std::vector<const Sample*> good;
+    for (const Sample& s : _samples) {
+      if (s.rtt <= limit) good.push_back(&s);
+    }
+
+    _ref = good.front()->dev;
+    double n = (double)good.size(), sx = 0, sy = 0, sxx = 0, sxy = 0, span = 0;
+    for (const Sample* s : good) {
+      double x = (double)(long long)(s->dev - _ref);
+      span = std::max(span, x);
+      double y = (double)(s->host - (long long)s->dev);
+      sx += x; sy += y; sxx += x * x; sxy += x * y;
+    }
+    double den = n * sxx - sx * sx;
+    // 표본 구간이 1초 미만이면 drift 는 0 으로 두고 평균 offset 만
+    _drift = (span >= 1e6 && den > 0) ? (n * sxy - sx * sy) / den : 0.0;
+    _offset = (sy - _drift * sx) / n;
+    _valid = true;
+  }
+
+  std::deque<Sample> _samples;
+  std::map<long, long long> _pending;
+  long _nextSeq = 1;
+  bool _valid = false;
+  unsigned long long _ref = 0;
+  double _offset = 0;
+  double _drift = 0;
+  long long _minRtt = 0;
+};
+
+#endif // HOST_CLOCKSYNC_H
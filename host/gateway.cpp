@@ -0,0 +1,700 @@
+// =======================================================
+// === 다중 보드 게이트웨이 (리눅스 데몬)
+// =======================================================
+// 한 캐비닛의 여러 Due 보드(ramen / powder / outlet / cup+cooker ...) 시리얼
+// 링크를 혼자 소유하고, 각 보드의 [...] 텔레메트리를 하나의 타임스탬프 상태로
+// 합친 뒤 유닉스 소켓 하나로 노출한다. 명령은 device 종류로 보드를 찾아 보낸다.
+//
+//   gateway [--listen 경로] [--baud N] 보드...
+//
+// 보드 지정:
+//   /dev/ttyACM0              시리얼 포트 (raw, --baud, 기본 115200)
+//   sim:cup=2,cooker=1        시뮬레이션 보드: botty_host --stdio 를 띄우고
+//                             해당 setting 을 보낸다 (실제 펌웨어 로직 그대로)
+//
+// 소켓 API (한 줄에 요청 하나, 응답도 한 줄 JSON):
+//   [{"device":"cup",...}]    device 종류를 가진 보드로 전달
+//   @N [{...}]                N 번 보드로 직접 전달 (setting / query 등)
+//   state                     합쳐진 상태 스냅샷 (연결된 보드의 장치만)
+//   boards                    보드 목록, 연결 상태, 담당 device
+//   subscribe                 이후 이벤트(에러 / fault, 동작 이벤트, setting 응답,
+//                             sched / mem 통계, 로그, 텍스트 출력)를 계속 받음
+//
+// 루프는 하나라 어디서도 쓰기를 기다리지 않는다. 보드 / 클라이언트마다 송신 큐를 두고
+// 쓸 수 있을 때(EPOLLOUT) 이어 쓴다. 명령은 프레임 통째로만 보드 큐에 넣고(못 넣으면
+// "board busy"), CLIENT_TX_MAX_BYTES 이상 밀린 클라이언트(읽지 않는 구독자)는 끊는다.
+//
+// 보드의 바이너리 로그 레코드는 logmsg.h 표로 풀어 "log" 이벤트로 보낸다.
+// 보드마다 1초에 한 번 ping 으로 기기 시각과 호스트 시각의 차이/drift 를 추정해
+// (clocksync.h) 상태와 로그에 기기 시각(dts)과 그에 해당하는 호스트 시각(at)을 붙인다.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "clocksync.h"
+#include "jsonflat.h"
+#include "logrecord.h"
+
+static const size_t LINE_MAX_BYTES = 8192;    // 보드/클라이언트 한 줄 최대 길이
+static const int RECONNECT_MS = 1000;         // 끊긴 시리얼 포트 재시도 간격
+static const int SYNC_INTERVAL_MS = 1000;     // 보드별 시각 동기 ping 간격
+static const size_t BOARD_TX_MAX_BYTES = 4096;     // 보드 송신 큐 (넘치는 명령은 거절)
+static const size_t CLIENT_TX_MAX_BYTES = 1 << 20; // 클라이언트 송신 큐 (넘치면 끊음)
+
+static long long nowUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static long long monoUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static long long monoMs() {
+  return monoUs() / 1000;
+}
+
+static std::string jsonEscape(const std::string& s) {
+  std::string o;
+  for (unsigned char c : s) {
+    if (c == '"' || c == '\\') { o += '\\'; o += (char)c; }
+    else if (c == '\n') o += "\\n";
+    else if (c == '\r') o += "\\r";
+    else if (c == '\t') o += "\\t";
+    else if (c < 0x20) { char b[8]; snprintf(b, sizeof(b), "\\u%04x", c); o += b; }
+    else o += (char)c;
+  }
+  return o;
+}
+
+// =======================================================
+// === 보드 / 클라이언트
+// =======================================================
+
+enum EndpointKind { EP_BOARD, EP_CLIENT, EP_LISTEN };
+
+struct Endpoint {
+  EndpointKind kind;
+  int index;  // boards[] 또는 clients[] 내 위치
+};
+
+struct Board {
+  std::string spec;             // 실행 인자 원문
+  bool simulated = false;
+  std::string simSetting;       // sim: 일 때 부팅 후 보낼 setting 명령
+  int fd = -1;                  // 읽기/쓰기 (시리얼) 또는 읽기 (sim)
+  int wfd = -1;                 // 쓰기 (sim 은 파이프가 따로)
+  pid_t pid = -1;
+  long long retryAtMs = 0;
+  logrec::Splitter rx{ LINE_MAX_BYTES };  // 텍스트 줄 / 로그 레코드 분리
+  std::set<std::string> devices;  // 이 보드가 담당하는 device 종류
+  ClockSync sync;                 // 기기 시각 -> 호스트 시각
+  long long nextSyncMs = 0;
+  long long lastFrameUs = 0;
+  unsigned long frames = 0;
+  std::string tx;                 // 아직 못 쓴 명령 바이트
+  bool txWatch = false;           // wfd 의 EPOLLOUT 감시 중
+};
+
+struct Client {
+  int fd = -1;
+  std::string rxLine;
+  std::string tx;                 // 아직 못 보낸 응답 / 이벤트
+  bool txWatch = false;
+  bool subscribed = false;
+};
+
+// 합쳐진 상태: "device/control" -> 최신 객체
+struct DeviceState {
+  int board;
+  long long rxUs;   // 게이트웨이 수신 시각
+  unsigned long long devUs;  // 프레임의 기기 시각 (ts, 없으면 0)
+  std::string obj;
+};
+
+static std::vector<Board> boards;
+static std::vector<Client> clients;
+static std::map<std::string, DeviceState> merged;
+static int epfd = -1;
+static int listenFd = -1;
+static speed_t baud = B115200;
+static std::string selfDir;
+
+static void epCtl(int op, int fd, EndpointKind kind, int index, uint32_t events) {
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.u64 = ((uint64_t)kind << 32) | (uint32_t)index;
+  epoll_ctl(epfd, op, fd, &ev);
+}
+
+static void epAdd(int fd, EndpointKind kind, int index) {
+  epCtl(EPOLL_CTL_ADD, fd, kind, index, EPOLLIN);
+}
+
+// 송신 큐에서 커널이 받는 만큼 쓴다. 0: 다 씀 / 1: 남음 (EAGAIN) / -1: 쓰기 오류
+static int writeSome(int fd, std::string& q) {
+  while (!q.empty()) {
+    ssize_t k = write(fd, q.data(), q.size());
+    if (k > 0) q.erase(0, (size_t)k);
+    else if (k < 0 && errno == EINTR) continue;
+    else if (k < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 1;
+    else return -1;
+  }
+  return 0;
+}
+
+static void closeClient(int i) {
+  Client& c = clients[i];
+  if (c.fd < 0) return;
+  epoll_ctl(epfd, EPOLL_CTL_DEL, c.fd, nullptr);
+  close(c.fd);
+  c = Client();
+}
+
+static void flushClient(int i) {
+  Client& c = clients[i];
+  int r = writeSome(c.fd, c.tx);
+  if (r < 0) {
+    closeClient(i);
+    return;
+  }
+  bool want = (r > 0);
+  if (want != c.txWatch) {
+    c.txWatch = want;
+    epCtl(EPOLL_CTL_MOD, c.fd, EP_CLIENT, i, want ? EPOLLIN | EPOLLOUT : EPOLLIN);
+  }
+}
+
+static void reply(Client& c, const std::string& line) {
+  if (c.fd < 0) return;
+  int i = (int)(&c - clients.data());
+  if (c.tx.size() + line.size() + 1 > CLIENT_TX_MAX_BYTES) {
+    fprintf(stderr, "gateway: client %d not reading, dropped\n", i);
+    closeClient(i);
+    return;
+  }
+  c.tx += line;
+  c.tx += '\n';
+  if (!c.txWatch) flushClient(i);  // 밀려 있으면 EPOLLOUT 때 이어 씀
+}
+
+static void broadcastEvent(int board, const std::string& kind, const std::string& body) {
+  char head[96];
+  snprintf(head, sizeof(head), "{\"ts\":%lld,\"board\":%d,\"%s\":", nowUs(), board, kind.c_str());
+  std::string line = head + body + "}";
+  for (Client& c : clients) {
+    if (c.subscribed) reply(c, line);
+  }
+}
+
+// =======================================================
+// === 보드 연결
+// =======================================================
+
+static bool openSerial(Board& b) {
+  int fd = open(b.spec.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (fd < 0) return false;
+
+  struct termios t;
+  if (tcgetattr(fd, &t) == 0) {
+    cfmakeraw(&t);
+    cfsetispeed(&t, baud);
+    cfsetospeed(&t, baud);
+    t.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(fd, TCSANOW, &t);
+  }
+  b.fd = b.wfd = fd;
+  return true;
+}
+
+// 시뮬레이션 보드: botty_host --stdio 를 자식으로 띄워 파이프로 연결
+static bool spawnSim(Board& b) {
+  int toChild[2], fromChild[2];
+  if (pipe(toChild) < 0 || pipe(fromChild) < 0) return false;
+
+  pid_t pid = fork();
+  if (pid < 0) return false;
+  if (pid == 0) {
+    dup2(toChild[0], STDIN_FILENO);
+    dup2(fromChild[1], STDOUT_FILENO);
+    close(toChild[1]);
+    close(fromChild[0]);
+    std::string exe = selfDir + "/botty_host";
+    execl(exe.c_str(), "botty_host", "--stdio", (char*)nullptr);
+    _exit(127);
+  }
+  close(toChild[0]);
+  close(fromChild[1]);
+  fcntl(fromChild[0], F_SETFL, O_NONBLOCK);
+  fcntl(toChild[1], F_SETFL, O_NONBLOCK);
+
+  b.pid = pid;
+  b.fd = fromChild[0];
+  b.wfd = toChild[1];
+  return true;
+}
+
+static void dropBoard(int i);
+
+// wfd 의 EPOLLOUT 감시 (시리얼은 읽기와 같은 fd, sim 은 파이프가 따로)
+static void watchBoardTx(int i, bool on) {
+  Board& b = boards[i];
+  if (b.txWatch == on) return;
+  b.txWatch = on;
+  if (b.wfd == b.fd) epCtl(EPOLL_CTL_MOD, b.fd, EP_BOARD, i, on ? EPOLLIN | EPOLLOUT : EPOLLIN);
+  else if (on) epCtl(EPOLL_CTL_ADD, b.wfd, EP_BOARD, i, EPOLLOUT);
+  else epoll_ctl(epfd, EPOLL_CTL_DEL, b.wfd, nullptr);
+}
+
+// 송신 큐를 쓸 수 있는 만큼 보낸다. 쓰기 오류면 보드를 내리고 false
+static bool flushBoard(int i) {
+  Board& b = boards[i];
+  if (b.fd < 0) return false;
+  int r = writeSome(b.wfd, b.tx);
+  if (r < 0) {
+    dropBoard(i);
+    return false;
+  }
+  watchBoardTx(i, r > 0);
+  return true;
+}
+
+enum BoardSend { SEND_OK, SEND_DOWN, SEND_BUSY };
+
+// 명령 프레임을 통째로 큐에 넣고 보낸다 (큐가 모자라면 한 바이트도 넣지 않음)
+static BoardSend sendFrame(int i, const std::string& frame) {
+  Board& b = boards[i];
+  if (b.fd < 0) return SEND_DOWN;
+  if (b.tx.size() + frame.size() > BOARD_TX_MAX_BYTES) return SEND_BUSY;
+  b.tx += frame;
+  if (b.txWatch) return SEND_OK;  // EPOLLOUT 때 이어 씀
+  return flushBoard(i) ? SEND_OK : SEND_DOWN;
+}
+
+static void connectBoard(int i) {
+  Board& b = boards[i];
+  bool ok = b.simulated ? spawnSim(b) : openSerial(b);
+  if (!ok) {
+    b.retryAtMs = monoMs() + RECONNECT_MS;
+    return;
+  }
+  b.rx.reset();
+  b.sync.reset();
+  b.nextSyncMs = monoMs();
+  b.tx.clear();
+  b.txWatch = false;
+  epAdd(b.fd, EP_BOARD, i);
+  fprintf(stderr, "gateway: board %d up (%s)\n", i, b.spec.c_str());
+
+  // sim 은 setting 적용, 실제 보드는 담당 device 확인
+  sendFrame(i, b.simulated ? b.simSetting : "[{\"device\":\"query\"}]");
+}
+
+static void dropBoard(int i) {
+  Board& b = boards[i];
+  if (b.fd < 0) return;
+  epoll_ctl(epfd, EPOLL_CTL_DEL, b.fd, nullptr);
+  if (b.wfd != b.fd && b.txWatch) epoll_ctl(epfd, EPOLL_CTL_DEL, b.wfd, nullptr);
+  close(b.fd);
+  if (b.wfd != b.fd) close(b.wfd);
+  b.tx.clear();
+  b.txWatch = false;
+  if (b.pid > 0) {
+    kill(b.pid, SIGTERM);
+    waitpid(b.pid, nullptr, 0);
+    b.pid = -1;
+  }
+  b.fd = b.wfd = -1;
+  b.retryAtMs = monoMs() + RECONNECT_MS;
+
+  // 끊긴 보드의 마지막 상태를 현재 상태로 내주지 않도록 합친 상태에서 뺀다
+  for (auto it = merged.begin(); it != merged.end();) {
+    if (it->second.board == i) it = merged.erase(it);
+    else ++it;
+  }
+  fprintf(stderr, "gateway: board %d down\n", i);
+  broadcastEvent(i, "link", "\"down\"");
+}
+
+// 명령을 받을 수 있는 device 종류 (sched, mem 등 보고 전용 레코드는 제외)
+static const char* const DEVICE_KINDS[] = { "cup", "ramen", "powder", "cooker", "outlet" };
+
+static bool isDeviceKind(const std::string& dev) {
+  for (const char* k : DEVICE_KINDS) {
+    if (dev == k) return true;
+  }
+  return false;
+}
+
+// setting 응답 / 텔레메트리에서 담당 device 갱신
+static void learnDevices(Board& b, const std::string& obj) {
+  std::string v;
+  for (const char* k : DEVICE_KINDS) {
+    if (jsonflat::findValue(obj, k, v) && atoi(v.c_str()) > 0) b.devices.insert(k);
+  }
+}
+
+// 기기 시각을 호스트 실시간(µs)으로. 동기 표본이 아직 없으면 0
+static long long deviceToWallUs(const Board& b, unsigned long long devUs) {
+  if (!b.sync.valid() || devUs == 0) return 0;
+  return b.sync.toHost(devUs) - monoUs() + nowUs();
+}
+
+static void handleBoardLine(int i, const std::string& line) {
+  Board& b = boards[i];
+  std::vector<std::string> objs;
+
+  if (!jsonflat::splitFrame(line, objs) || objs.empty()) {
+    // 프레임이 아닌 출력 (디버그 문자열 등)
+    if (!line.empty()) broadcastEvent(i, "text", "\"" + jsonEscape(line) + "\"");
+    return;
+  }
+
+  long long t = nowUs();
+  std::string tmp;
+  unsigned long long devUs = 0;  // 프레임 첫 객체의 ts 가 프레임 전체의 기기 시각
+  if (jsonflat::findValue(objs[0], "ts", tmp)) devUs = strtoull(tmp.c_str(), nullptr, 10);
+
+  for (const std::string& obj : objs) {
+    std::string dev, ctl;
+    if (!jsonflat::findValue(obj, "device", dev)) {
+      if (jsonflat::findValue(obj, "boot", tmp)) b.sync.reset();  // 기기 시각이 0 부터 다시 시작
+      broadcastEvent(i, "event", obj);  // {"boot":...} 등
+      continue;
+    }
+    if (dev == "pong") {
+      if (jsonflat::findValue(obj, "seq", tmp)) b.sync.pong(atol(tmp.c_str()), devUs, monoUs());
+      continue;
+    }
+    if (dev == "setting") {
+      b.devices.clear();
+      learnDevices(b, obj);
+      broadcastEvent(i, "event", obj);
+      continue;
+    }
+    // 에러 / 동작 마감 초과: 상태가 아니라 사건
+    if (jsonflat::findValue(obj, "error", tmp) || jsonflat::findValue(obj, "fault", tmp)) {
+      broadcastEvent(i, "event", obj);
+      continue;
+    }
+    // 동작 완료 등 이벤트, 스케줄러 / 메모리 통계: 합친 상태에 넣지 않고 그대로 전달
+    if (jsonflat::findValue(obj, "event", tmp) || (dev != "door" && !isDeviceKind(dev))) {
+      broadcastEvent(i, "event", obj);
+      continue;
+    }
+
+    // 상태 객체: 합쳐진 상태 갱신
+    if (dev != "door") b.devices.insert(dev);
+    std::string key = dev;
+    if (jsonflat::findValue(obj, "control", ctl)) key += "/" + ctl;
+    else key += "@" + std::to_string(i);  // door 등 번호 없는 장치는 보드별로
+    merged[key] = DeviceState{ i, t, devUs, obj };
+  }
+  b.lastFrameUs = t;
+  b.frames++;
+}
+
+static void handleBoardLog(int i, const logrec::Record& r) {
+  std::string args;
+  for (unsigned a = 0; a < r.argc; a++) {
+    if (a) args += ',';
+    args += std::to_string(r.args[a]);
+  }
+  broadcastEvent(i, "log", "{\"id\":" + std::to_string(r.id) +
+                 ",\"dts\":" + std::to_string(r.ts) +
+                 ",\"at\":" + std::to_string(deviceToWallUs(boards[i], r.ts)) +
+                 ",\"level\":\"" + logrec::levelName(r.level) + "\"" +
+                 ",\"msg\":\"" + jsonEscape(logrec::expand(r)) + "\"" +
+                 ",\"args\":[" + args + "]}");
+}
+
+static void readBoard(int i) {
+  Board& b = boards[i];
+  char buf[4096];
+
+  for (;;) {
+    ssize_t k = read(b.fd, buf, sizeof(buf));
+    if (k > 0) {
+      for (ssize_t j = 0; j < k; j++) {
+        b.rx.feed((uint8_t)buf[j],
+                  [i](const std::string& line) { handleBoardLine(i, line); },
+                  [i](const logrec::Record& r) { handleBoardLog(i, r); });
+      }
+      continue;
+    }
+    if (k < 0 && (errno == EAGAIN || errno == EINTR)) return;
+    dropBoard(i);
+    return;
+  }
+}
+
+// =======================================================
+// === 클라이언트 API
+// =======================================================
+
+static std::string stateJson() {
+  std::string o = "{\"ts\":" + std::to_string(nowUs()) + ",\"devices\":[";
+  bool first = true;
+  for (const auto& kv : merged) {
+    if (!first) o += ',';
+    first = false;
+    const DeviceState& d = kv.second;
+    o += "{\"board\":" + std::to_string(d.board) +
+         ",\"rx\":" + std::to_string(d.rxUs) +
+         ",\"dts\":" + std::to_string(d.devUs) +
+         ",\"at\":" + std::to_string(deviceToWallUs(boards[d.board], d.devUs)) +
+         ",\"state\":" + d.obj + "}";
+  }
+  return o + "]}";
+}
+
+static std::string boardsJson() {
+  std::string o = "{\"boards\":[";
+  for (size_t i = 0; i < boards.size(); i++) {
+    const Board& b = boards[i];
+    if (i) o += ',';
+    o += "{\"board\":" + std::to_string(i) +
+         ",\"spec\":\"" + jsonEscape(b.spec) + "\"" +
+         ",\"up\":" + (b.fd >= 0 ? "true" : "false") +
+         ",\"frames\":" + std::to_string(b.frames) +
+         ",\"last\":" + std::to_string(b.lastFrameUs);
+    if (b.sync.valid()) {
+      char sync[160];
+      snprintf(sync, sizeof(sync),
+               ",\"sync\":{\"offset_us\":%lld,\"drift_ppm\":%.2f,\"rtt_us\":%lld,\"samples\":%zu}",
+               b.sync.offsetUs(), b.sync.driftPpm(), b.sync.minRttUs(), b.sync.samples());
+      o += sync;
+    }
+    o += ",\"devices\":[";
+    bool first = true;
+    for (const std::string& d : b.devices) {
+      if (!first) o += ',';
+      first = false;
+      o += "\"" + d + "\"";
+    }
+    o += "]}";
+  }
+  return o + "]}";
+}
+
+static int findBoardFor(const std::string& dev) {
+  for (size_t i = 0; i < boards.size(); i++) {
+    if (boards[i].fd >= 0 && boards[i].devices.count(dev)) return (int)i;
+  }
+  return -1;
+}
+
+static void sendToBoard(Client& c, int bi, const std::string& frame) {
+  BoardSend r = (bi < 0 || bi >= (int)boards.size()) ? SEND_DOWN : sendFrame(bi, frame);
+  if (r == SEND_DOWN) {
+    reply(c, "{\"ok\":false,\"error\":\"board not available\"}");
+  } else if (r == SEND_BUSY) {
+    reply(c, "{\"ok\":false,\"error\":\"board busy\"}");
+  } else {
+    reply(c, "{\"ok\":true,\"board\":" + std::to_string(bi) + "}");
+  }
+}
+
+static void handleClientLine(Client& c, std::string line) {
+  while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+  if (line.empty()) return;
+
+  if (line == "state") {
+    reply(c, stateJson());
+  } else if (line == "boards") {
+    reply(c, boardsJson());
+  } else if (line == "subscribe") {
+    c.subscribed = true;
+    reply(c, "{\"ok\":true}");
+  } else if (line[0] == '@') {
+    char* end;
+    long bi = strtol(line.c_str() + 1, &end, 10);
+    while (*end == ' ') end++;
+    sendToBoard(c, (int)bi, end);
+  } else if (line[0] == '[') {
+    std::vector<std::string> objs;
+    std::string dev;
+    if (!jsonflat::splitFrame(line, objs) || objs.size() != 1 || !jsonflat::findValue(objs[0], "device", dev)) {
+      reply(c, "{\"ok\":false,\"error\":\"expected [{\\\"device\\\":...}]\"}");
+      return;
+    }
+    int bi = findBoardFor(dev);
+    if (bi < 0) {
+      reply(c, "{\"ok\":false,\"error\":\"no board for device " + jsonEscape(dev) + "\"}");
+      return;
+    }
+    sendToBoard(c, bi, line);
+  } else {
+    reply(c, "{\"ok\":false,\"error\":\"unknown request\"}");
+  }
+}
+
+static void acceptClient() {
+  int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+  if (fd < 0) return;
+
+  // 빈 자리 재사용
+  size_t i = 0;
+  while (i < clients.size() && clients[i].fd >= 0) i++;
+  if (i == clients.size()) clients.push_back(Client());
+  clients[i] = Client();
+  clients[i].fd = fd;
+  epAdd(fd, EP_CLIENT, (int)i);
+}
+
+static void readClient(int i) {
+  char buf[4096];
+  ssize_t k = read(clients[i].fd, buf, sizeof(buf));
+  if (k < 0 && (errno == EAGAIN || errno == EINTR)) return;
+  if (k <= 0) {
+    closeClient(i);
+    return;
+  }
+  for (ssize_t j = 0; j < k; j++) {
+    Client& c = clients[i];
+    if (c.fd < 0) return;  // 응답 중 끊김 (밀린 클라이언트)
+    if (buf[j] == '\n') {
+      std::string line;
+      line.swap(c.rxLine);
+      handleClientLine(c, line);
+    } else if (c.rxLine.size() < LINE_MAX_BYTES) {
+      c.rxLine += buf[j];
+    }
+  }
+}
+
+// =======================================================
+// === main
+// =======================================================
+
+static bool parseSim(Board& b) {
+  // sim:cup=2,cooker=1 -> [{"device":"setting","cup":2,"cooker":1}]
+  std::string s = b.spec.substr(4);
+  std::string cmd = "[{\"device\":\"setting\"";
+  size_t p = 0;
+  while (p < s.size()) {
+    size_t e = s.find(',', p);
+    if (e == std::string::npos) e = s.size();
+    std::string kv = s.substr(p, e - p);
+    size_t eq = kv.find('=');
+    if (eq == std::string::npos) return false;
+    cmd += ",\"" + kv.substr(0, eq) + "\":" + std::to_string(atoi(kv.c_str() + eq + 1));
+    p = e + 1;
+  }
+  b.simSetting = cmd + "}]";
+  b.simulated = true;
+  return true;
+}
+
+static speed_t toSpeed(long v) {
+  switch (v) {
+    case 9600: return B9600;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default: return B115200;
+  }
+}
+
+int main(int argc, char** argv) {
+  const char* listenPath = "/tmp/botty-gateway.sock";
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--listen") == 0 && i + 1 < argc) {
+      listenPath = argv[++i];
+    } else if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+      baud = toSpeed(atol(argv[++i]));
+    } else {
+      Board b;
+      b.spec = argv[i];
+      if (b.spec.compare(0, 4, "sim:") == 0 && !parseSim(b)) {
+        fprintf(stderr, "gateway: bad sim spec %s\n", argv[i]);
+        return 2;
+      }
+      boards.push_back(b);
+    }
+  }
+  if (boards.empty()) {
+    fprintf(stderr, "usage: gateway [--listen path] [--baud N] <tty|sim:cup=2,...>...\n");
+    return 2;
+  }
+
+  char exe[PATH_MAX];
+  ssize_t n = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+  if (n > 0) {
+    exe[n] = '\0';
+    selfDir = std::string(exe, strrchr(exe, '/') - exe);
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+  epfd = epoll_create1(0);
+
+  listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un a;
+  memset(&a, 0, sizeof(a));
+  a.sun_family = AF_UNIX;
+  strncpy(a.sun_path, listenPath, sizeof(a.sun_path) - 1);
+  unlink(listenPath);
+  if (bind(listenFd, (struct sockaddr*)&a, sizeof(a)) < 0 || listen(listenFd, 8) < 0) {
+    perror("gateway: listen");
+    return 1;
+  }
+  epAdd(listenFd, EP_LISTEN, 0);
+  fprintf(stderr, "gateway: listening on %s\n", listenPath);
+
+  for (size_t i = 0; i < boards.size(); i++) connectBoard((int)i);
+
+  struct epoll_event evs[16];
+  for (;;) {
+    int k = epoll_wait(epfd, evs, 16, 100);
+    for (int j = 0; j < k; j++) {
+      EndpointKind kind = (EndpointKind)(evs[j].data.u64 >> 32);
+      int idx = (int)(uint32_t)evs[j].data.u64;
+      uint32_t e = evs[j].events;
+      if (kind == EP_LISTEN) {
+        acceptClient();
+      } else if (kind == EP_BOARD) {
+        if (e & (EPOLLOUT | EPOLLERR)) flushBoard(idx);
+        if ((e & ~EPOLLOUT) && boards[idx].fd >= 0) readBoard(idx);
+      } else {
+        if (e & EPOLLOUT) flushClient(idx);
+        if ((e & ~EPOLLOUT) && clients[idx].fd >= 0) readClient(idx);
+      }
+    }
+
+    long long now = monoMs();
+    for (size_t i = 0; i < boards.size(); i++) {
+      Board& b = boards[i];
+      if (b.fd < 0) {
+        if (now >= b.retryAtMs) connectBoard((int)i);
+      } else if (now >= b.nextSyncMs) {
+        b.nextSyncMs = now + SYNC_INTERVAL_MS;
+        long seq = b.sync.ping(monoUs());
+        sendFrame((int)i, "[{\"device\":\"ping\",\"seq\":" + std::to_string(seq) + "}]");
+      }
+    }
+  }
+}
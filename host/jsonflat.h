@@ -0,0 +1,69 @@
+#ifndef HOST_JSONFLAT_H
+#define HOST_JSONFLAT_H
+
+// =======================================================
+// === JSON 조각 처리 (평면 객체 전용, 펌웨어 프레임 형식 기준)
+// =======================================================
+// 게이트웨이 / 시뮬레이터가 보드 프레임 "[{...},{...}]" 을 객체로 나누고
+// 최상위 키 값을 꺼낼 때 쓴다. 배열 값([min,max,...])은 원문 그대로 돌려준다.
+
+#include <string>
+#include <vector>
+
+namespace jsonflat {
+
+// 최상위 배열 "[{...},{...}]" 을 객체 문자열들로 나눈다
+inline bool splitFrame(const std::string& line, std::vector<std::string>& objs) {
+  size_t i = 0, n = line.size();
+  while (i < n && line[i] != '[') i++;
+  if (i == n) return false;
+
+  int depth = 0;
+  bool inStr = false;
+  size_t start = 0;
+  for (i++; i < n; i++) {
+    char c = line[i];
+    if (inStr) {
+      if (c == '\\') i++;
+      else if (c == '"') inStr = false;
+      continue;
+    }
+    if (c == '"') {
+      inStr = true;
+    } else if (c == '{') {
+      if (depth++ == 0) start = i;
+    } else if (c == '}') {
+      if (--depth == 0) objs.push_back(line.substr(start, i - start + 1));
+      if (depth < 0) return false;
+    } else if (c == ']' && depth == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// 객체의 최상위 키 값 (문자열이면 따옴표 제외, 아니면 원문, 배열은 [] 포함) 을 찾는다
+inline bool findValue(const std::string& obj, const char* key, std::string& out) {
+  std::string pat = std::string("\"") + key + "\":";
+  size_t p = obj.find(pat);
+  if (p == std::string::npos) return false;
+  p += pat.size();
+  if (p < obj.size() && obj[p] == '"') {
+    size_t e = obj.find('"', p + 1);
+    if (e == std::string::npos) return false;
+    out = obj.substr(p + 1, e - p - 1);
+  } else if (p < obj.size() && obj[p] == '[') {
+    size_t e = obj.find(']', p);
+    if (e == std::string::npos) return false;
+    out = obj.substr(p, e - p + 1);
+  } else {
+    size_t e = obj.find_first_of(",}", p);
+    if (e == std::string::npos) return false;
+    out = obj.substr(p, e - p);
+  }
+  return true;
+}
+
+}  // namespace jsonflat
+
+#endif // HOST_JSONFLAT_H
@@ -0,0 +1,109 @@
+// =======================================================
+// === 로그 레코드 해석기
+// =======================================================
+// 보드 출력(시리얼 포트, 캡처 파일, 표준입력)을 읽어 JSON 프레임 등 텍스트 줄은
+// 그대로 내보내고, 바이너리 로그 레코드는 logmsg.h 표로 풀어 한 줄씩 출력한다.
+// 로그 줄의 시각은 기기 시각 (부팅 후 초.µs).
+//
+//   logdecode [--min 레벨] [--baud N] [입력]   입력 생략 시 표준입력
+//   logdecode --table                         메시지 표(JSON) 출력 (다른 도구용)
+//
+//   ./build/botty_host --stdio < cmds.txt | ./build/logdecode
+//   ./build/logdecode --min WARN /dev/ttyACM0
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "logrecord.h"
+
+static int parseLevel(const char* s) {
+  for (int l = 0; l < 4; l++) {
+    if (strcasecmp(s, logrec::levelName(l)) == 0) return l;
+  }
+  return atoi(s);
+}
+
+static void printTable() {
+  printf("[");
+  for (unsigned i = 0; i < logrec::TABLE_SIZE; i++) {
+    const logrec::Entry& e = logrec::TABLE[i];
+    std::string fmt;
+    for (const char* p = e.fmt; *p; p++) {
+      if (*p == '"' || *p == '\\') fmt += '\\';
+      fmt += *p;
+    }
+    printf("%s\n{\"id\":%u,\"name\":\"%s\",\"level\":\"%s\",\"fmt\":\"%s\"}",
+           i ? "," : "", i, e.name, logrec::levelName(e.level), fmt.c_str());
+  }
+  printf("\n]\n");
+}
+
+static int openInput(const char* path, speed_t baud) {
+  int fd = open(path, O_RDONLY | O_NOCTTY);
+  if (fd < 0) return -1;
+
+  struct termios t;
+  if (isatty(fd) && tcgetattr(fd, &t) == 0) {
+    cfmakeraw(&t);
+    cfsetispeed(&t, baud);
+    cfsetospeed(&t, baud);
+    t.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(fd, TCSANOW, &t);
+  }
+  return fd;
+}
+
+int main(int argc, char** argv) {
+  int minLevel = 0;
+  speed_t baud = B115200;
+  const char* path = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--table") == 0) {
+      printTable();
+      return 0;
+    } else if (strcmp(argv[i], "--min") == 0 && i + 1 < argc) {
+      minLevel = parseLevel(argv[++i]);
+    } else if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+      long b = atol(argv[++i]);
+      baud = b == 9600 ? B9600 : b == 57600 ? B57600 : b == 230400 ? B230400 : B115200;
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "usage: %s [--min level] [--baud n] [input] | --table\n", argv[0]);
+      return 2;
+    } else {
+      path = argv[i];
+    }
+  }
+
+  int fd = STDIN_FILENO;
+  if (path && (fd = openInput(path, baud)) < 0) {
+    fprintf(stderr, "logdecode: %s: %s\n", path, strerror(errno));
+    return 1;
+  }
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+
+  logrec::Splitter split;
+  char buf[4096];
+  for (;;) {
+    ssize_t k = read(fd, buf, sizeof(buf));
+    if (k < 0 && errno == EINTR) continue;
+    if (k <= 0) break;
+    for (ssize_t j = 0; j < k; j++) {
+      split.feed((uint8_t)buf[j],
+                 [](const std::string& line) { printf("%s\n", line.c_str()); },
+                 [minLevel](const logrec::Record& r) {
+                   if (r.level < minLevel) return;
+                   printf("[%s %llu.%06llu] %s\n", logrec::levelName(r.level),
+                          r.ts / 1000000, r.ts % 1000000, logrec::expand(r).c_str());
+                 });
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,154 @@
+#ifndef HOST_LOGRECORD_H
+#define HOST_LOGRECORD_H
+
+// =======================================================
+// === 바이너리 로그 레코드 복원 (호스트 도구 공용)
+// =======================================================
+// 보드 출력에 섞여 오는 0x1F 로그 레코드(../log.h)를 텍스트 줄과 분리하고,
+// ../logmsg.h 를 그대로 include 해 만든 문자열 표로 메시지를 복원한다.
+
+#include <stdint.h>
+#include <string>
+
+namespace logrec {
+
+enum { LOG_DEBUG = 0, LOG_INFO = 1, LOG_WARN = 2, LOG_ERROR = 3 };
+
+struct Entry {
+  const char* name;
+  int level;
+  const char* fmt;
+};
+
+static const Entry TABLE[] = {
+#define LOGMSG(id, level, fmt) { #id, level, fmt },
+#include "../logmsg.h"
+#undef LOGMSG
+};
+static const unsigned TABLE_SIZE = sizeof(TABLE) / sizeof(TABLE[0]);
+
+static const uint8_t TAG = 0x1F;
+static const unsigned MAX_ARGS = 4;
+static const unsigned MAX_BODY = 2 + 1 + 10 + MAX_ARGS * 5;  // id + level/argc + ts + varint 인자
+
+struct Record {
+  unsigned id;
+  int level;
+  unsigned argc;
+  unsigned long long ts;  // 기기 시각 µs
+  long args[MAX_ARGS];
+};
+
+inline const char* levelName(int level) {
+  static const char* names[] = { "DEBUG", "INFO", "WARN", "ERROR" };
+  return level >= 0 && level < 4 ? names[level] : "?";
+}
+
+// 형식 문자열의 %d 를 인자로 치환 (표에 없는 ID 는 번호와 인자만)
+inline std::string expand(const Record& r) {
+  std::string out;
+  unsigned used = 0;
+
+  if (r.id >= TABLE_SIZE) {
+    out = "#" + std::to_string(r.id);
+    for (unsigned i = 0; i < r.argc; i++) out += " " + std::to_string(r.args[i]);
+    return out;
+  }
+  for (const char* p = TABLE[r.id].fmt; *p; p++) {
+    if (p[0] == '%' && p[1] == 'd' && used < r.argc) {
+      out += std::to_string(r.args[used++]);
+      p++;
+    } else {
+      out += *p;
+    }
+  }
+  return out;
+}
+
+// 바이트 스트림을 텍스트 줄과 로그 레코드로 나눈다.
+// 레코드 검사(길이, 체크섬, varint)에 실패하면 태그 바이트만 버리고 나머지는 텍스트로 다시 본다.
+class Splitter {
+ public:
+  explicit Splitter(size_t maxLine = 8192) : _maxLine(maxLine) {}
+
+  template <typename LineFn, typename RecordFn>
+  void feed(uint8_t c, LineFn onLine, RecordFn onRecord) {
+    if (!_rec.empty()) {
+      _rec += (char)c;
+      if (_rec.size() >= 2) {
+        size_t len = (uint8_t)_rec[1];
+        if (len < 3 || len > MAX_BODY) return reject(onLine, onRecord);
+        if (_rec.size() == len + 3) {
+          Record r;
+          if (!decode(r)) return reject(onLine, onRecord);
+          _rec.clear();
+          onRecord(r);
+        }
+      }
+      return;
+    }
+    if (c == TAG) {
+      _rec.assign(1, (char)c);
+    } else if (c == '\n') {
+      if (!_line.empty() && _line.back() == '\r') _line.pop_back();
+      onLine(_line);
+      _line.clear();
+    } else if (_line.size() < _maxLine) {
+      _line += (char)c;
+    }
+  }
+
+  void reset() {
+    _line.clear();
+    _rec.clear();
+  }
+
+ private:
+  bool decode(Record& r) const {
+    const uint8_t* p = (const uint8_t*)_rec.data();
+    size_t len = p[1];
+    uint8_t sum = 0;
+    for (size_t i = 2; i < 2 + len; i++) sum += p[i];
+    if (sum != p[2 + len]) return false;
+
+    r.id = p[2] | (p[3] << 8);
+    r.level = p[4] >> 4;
+    r.argc = p[4] & 0x0F;
+    if (r.argc > MAX_ARGS) return false;
+
+    size_t k = 5, end = 2 + len;
+    if (!varint(p, k, end, 63, r.ts)) return false;
+    for (unsigned a = 0; a < r.argc; a++) {
+      unsigned long long z;
+      if (!varint(p, k, end, 28, z)) return false;
+      r.args[a] = (long)(int32_t)(((uint32_t)z >> 1) ^ (0u - ((uint32_t)z & 1)));
+    }
+    return k == end;
+  }
+
+  static bool varint(const uint8_t* p, size_t& k, size_t end, unsigned maxShift,
+                     unsigned long long& out) {
+    out = 0;
+    for (unsigned shift = 0;; shift += 7) {
+      if (k >= end || shift > maxShift) return false;
+      uint8_t b = p[k++];
+      out |= (unsigned long long)(b & 0x7F) << shift;
+      if (!(b & 0x80)) return true;
+    }
+  }
+
+  template <typename LineFn, typename RecordFn>
+  void reject(LineFn onLine, RecordFn onRecord) {
+    std::string rest = _rec.substr(1);
+    _rec.clear();
+    for (char ch : rest) feed((uint8_t)ch, onLine, onRecord);
+  }
+
+  size_t _maxLine;
+  std::string _line;
+  std::string _rec;
+};
+
+} // namespace logrec
+
+#endif // HOST_LOGRECORD_H
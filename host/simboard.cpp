@@ -0,0 +1,70 @@
+// =======================================================
+// === 시뮬레이션 보드 (build/botty_sim.so)
+// =======================================================
+// botty_host.cpp 의 파일/소켓 링크 대신 메모리 버퍼 링크를 붙이고,
+// 시뮬레이터(cabinetsim)가 가상 시각으로 한 스텝씩 돌린다.
+
+#include <Arduino.h>
+#include <string>
+#include "simboard.h"
+
+void setup();
+void loop();
+
+class MemStream : public Stream {
+public:
+  int available() override { return (int)(_in.size() - _head); }
+  int read() override { return (_head < _in.size()) ? (uint8_t)_in[_head++] : -1; }
+  int peek() override { return (_head < _in.size()) ? (uint8_t)_in[_head] : -1; }
+  void flush() override {}
+
+  size_t write(uint8_t c) override { _out += (char)c; return 1; }
+  size_t write(const uint8_t* buf, size_t n) override {
+    _out.append((const char*)buf, n);
+    return n;
+  }
+  using Print::write;
+
+  void push(const char* s) {
+    if (_head == _in.size()) { _in.clear(); _head = 0; }
+    _in += s;
+  }
+
+  size_t take(uint8_t* buf, size_t cap) {
+    size_t n = _out.size() < cap ? _out.size() : cap;
+    memcpy(buf, _out.data(), n);
+    _out.erase(0, n);
+    return n;
+  }
+
+private:
+  std::string _in;
+  size_t _head = 0;
+  std::string _out;
+};
+
+static MemStream simLink;
+
+Stream* hostTransportStream() { return &simLink; }
+
+extern "C" {
+
+void simBoot() {
+  hostUseVirtualTime();
+  setup();
+}
+
+void simStep(unsigned long us) {
+  hostAdvanceMicros(us);
+  loop();
+}
+
+void simSend(const char* line) { simLink.push(line); }
+
+size_t simTake(uint8_t* buf, size_t cap) { return simLink.take(buf, cap); }
+
+int simRead(uint8_t pin) { return digitalRead(pin); }
+void simWrite(uint8_t pin, int level) { hostSetPin(pin, level); }
+void simAnalog(uint8_t pin, int value) { hostSetAnalog(pin, value); }
+
+}
@@ -0,0 +1,47 @@
+#ifndef HOST_SIMBOARD_H
+#define HOST_SIMBOARD_H
+
+// =======================================================
+// === 시뮬레이션 보드 (펌웨어 공유 라이브러리 진입점)
+// =======================================================
+// build/botty_sim.so 는 펌웨어 소스 전체(스케치, ../*.cpp)를 가상 시각의
+// Arduino 대체와 함께 묶은 것이다. 보드 하나마다 이 파일의 복사본을 따로
+// dlopen 하면 전역 상태(current, state, 큐 ...)가 보드별로 분리된다.
+// 링크는 메모리 버퍼: simSend 로 넣은 명령을 펌웨어가 읽고, 펌웨어가 쓴
+// 프레임 / 로그 레코드는 simTake 로 꺼낸다.
+
+#include <stddef.h>
+#include <stdint.h>
+
+extern "C" {
+
+// 가상 시각을 켜고 setup() 실행
+void simBoot();
+
+// 가상 시각을 us 만큼 넘기고 loop() 한 번 (스케줄러가 밀린 틱을 처리)
+void simStep(unsigned long us);
+
+// 명령 한 줄 ("[{...}]") 을 수신 버퍼에 넣는다
+void simSend(const char* line);
+
+// 펌웨어가 보낸 바이트를 최대 cap 만큼 꺼낸다 (꺼낸 길이 반환)
+size_t simTake(uint8_t* buf, size_t cap);
+
+// 핀 (출력 읽기 / 입력 주입, 입력 변화는 ISR 을 부른다)
+int simRead(uint8_t pin);
+void simWrite(uint8_t pin, int level);
+void simAnalog(uint8_t pin, int value);
+}
+
+// dlsym 으로 찾는 함수 포인터 묶음
+struct SimBoardApi {
+  void (*boot)();
+  void (*step)(unsigned long);
+  void (*send)(const char*);
+  size_t (*take)(uint8_t*, size_t);
+  int (*read)(uint8_t);
+  void (*write)(uint8_t, int);
+  void (*analog)(uint8_t, int);
+};
+
+#endif // HOST_SIMBOARD_H
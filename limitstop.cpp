@@ -0,0 +1,92 @@
+#include <Arduino.h>
+#include "limitstop.h"
+#include "config.h"
+
+// 리밋 입력 하나와 그 입력이 멈추는 출력
+struct LimitBinding {
+  uint8_t inPin;
+  uint8_t level;                    // 리밋 도달 시 입력 레벨
+  uint8_t outPin;
+  const unsigned long* since;       // 설정 시: 출력 시작 시각 (이 시각 + armDelay 이전엔 무시)
+  const unsigned long* armDelayMs;
+};
+
+// 최대 조합: ramen 4대 x 리밋 4개
+static const uint8_t MAX_LIMITS = 16;
+static const uint8_t PIN_SLOTS = 80;
+
+static LimitBinding bindings[MAX_LIMITS];
+static uint8_t bindingCount = 0;
+static volatile bool limitStopped[PIN_SLOTS];
+
+// ISR 안에서 출력을 끊는다. Due 의 digitalWrite 는 PIO_SODR/CODR(원자적 set/clear)
+// 레지스터를 쓰므로 loop 의 다른 핀 쓰기와 겹쳐도 안전하다.
+static void onLimit(uint8_t n) {
+  const LimitBinding& b = bindings[n];
+
+  if (digitalRead(b.inPin) != b.level) return;
+  if (digitalRead(b.outPin) != HIGH) return;
+  if (b.since && millis() - *b.since < *b.armDelayMs) return;
+
+  digitalWrite(b.outPin, LOW);
+  limitStopped[b.outPin] = true;
+}
+
+// attachInterrupt 는 인자 없는 함수만 받으므로 슬롯별 ISR 을 만든다
+template <uint8_t N>
+static void limitIsr() { onLimit(N); }
+
+static void (* const LIMIT_ISRS[MAX_LIMITS])() = {
+  limitIsr<0>,  limitIsr<1>,  limitIsr<2>,  limitIsr<3>,
+  limitIsr<4>,  limitIsr<5>,  limitIsr<6>,  limitIsr<7>,
+  limitIsr<8>,  limitIsr<9>,  limitIsr<10>, limitIsr<11>,
+  limitIsr<12>, limitIsr<13>, limitIsr<14>, limitIsr<15>,
+};
+
+static void bindLimit(uint8_t inPin, uint8_t level, uint8_t outPin,
+                      const unsigned long* since = nullptr, const unsigned long* armDelayMs = nullptr) {
+  if (bindingCount >= MAX_LIMITS) return;
+
+  uint8_t n = bindingCount++;
+  bindings[n].inPin = inPin;
+  bindings[n].level = level;
+  bindings[n].outPin = outPin;
+  bindings[n].since = since;
+  bindings[n].armDelayMs = armDelayMs;
+  limitStopped[outPin] = false;
+  attachInterrupt(digitalPinToInterrupt(inPin), LIMIT_ISRS[n], CHANGE);
+}
+
+void attachLimitInterrupts(const Setting& s) {
+  uint8_t i;
+
+  for (i = 0; i < bindingCount; i++) {
+    detachInterrupt(digitalPinToInterrupt(bindings[i].inPin));
+  }
+  bindingCount = 0;
+
+  // 용기: 배출 감지 LOW (단, 배출 시작 후 cupReleaseInterval 이 지난 뒤부터)
+  for (i = 0; i < s.cup; i++) {
+    bindLimit(CUP_DISP_IN[i], LOW, CUP_MOTOR_OUT[i], &startCupReleaseTime[i], &cupReleaseInterval);
+  }
+
+  // 면: 상승 상/하한, 배출 상/하한
+  for (i = 0; i < s.ramen; i++) {
+    bindLimit(RAMEN_UP_TOP_IN[i], HIGH, RAMEN_UP_FWD_OUT[i]);
+    bindLimit(RAMEN_UP_BTM_IN[i], HIGH, RAMEN_UP_REV_OUT[i]);
+    bindLimit(RAMEN_EJ_TOP_IN[i], HIGH, RAMEN_EJ_FWD_OUT[i]);
+    bindLimit(RAMEN_EJ_BTM_IN[i], HIGH, RAMEN_EJ_REV_OUT[i]);
+  }
+
+  // 배출구: 열림 / 닫힘 리밋
+  for (i = 0; i < s.outlet; i++) {
+    bindLimit(OUTLET_OPEN_IN[i], HIGH, OUTLET_FWD_OUT[i]);
+    bindLimit(OUTLET_CLOSE_IN[i], HIGH, OUTLET_REV_OUT[i]);
+  }
+}
+
+bool takeLimitStop(uint8_t outPin) {
+  if (outPin >= PIN_SLOTS || !limitStopped[outPin]) return false;
+  limitStopped[outPin] = false;
+  return true;
+}
@@ -0,0 +1,21 @@
+#ifndef LIMITSTOP_H
+#define LIMITSTOP_H
+
+#include <Arduino.h>
+#include "state.h"
+
+// =======================================================
+// === 리밋 센서 인터럽트 정지
+// =======================================================
+// 현재 Setting 의 리밋 입력마다 핀 변화 인터럽트를 걸고, 리밋에 도달하면
+// ISR 안에서 해당 출력을 바로 끈다 (loop 주기와 무관하게 수 us 안에 정지).
+// 완료 메시지, 감시 해제 같은 후처리는 check* 함수가 takeLimitStop() 으로
+// ISR 정지 여부를 확인하여 한다. 폴링 감시는 그대로 남아 보조 역할을 한다.
+
+// applySetting 에서 호출: 이전 인터럽트를 모두 떼고 새 설정 기준으로 다시 건다
+void attachLimitInterrupts(const Setting& s);
+
+// outPin 이 ISR 에 의해 정지되었으면 true 를 돌려주고 표시를 지운다
+bool takeLimitStop(uint8_t outPin);
+
+#endif // LIMITSTOP_H
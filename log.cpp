@@ -0,0 +1,62 @@
+#include <Arduino.h>
+#include "log.h"
+#include "transport.h"
+#include "devclock.h"
+
+#ifndef LOG_TEXT
+// 7비트씩, 이어지는 바이트가 있으면 최상위 비트 1
+static uint8_t putVarint(uint8_t* p, uint64_t z) {
+  uint8_t n = 0;
+  while (z >= 0x80) {
+    p[n++] = (uint8_t)(z | 0x80);
+    z >>= 7;
+  }
+  p[n++] = (uint8_t)z;
+  return n;
+}
+
+// 부호 있는 값을 작은 절댓값일수록 짧게: 0,-1,1,-2.. -> 0,1,2,3..
+static uint8_t putSigned(uint8_t* p, long v) {
+  return putVarint(p, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+void logWrite(LogMsgId id, uint8_t level, const long* args, uint8_t argc) {
+  uint8_t buf[2 + 3 + 10 + LOG_MAX_ARGS * 5 + 1];
+  uint8_t n = 2;
+
+  buf[n++] = (uint8_t)(id & 0xFF);
+  buf[n++] = (uint8_t)(id >> 8);
+  buf[n++] = (uint8_t)((level << 4) | argc);
+  n += putVarint(buf + n, deviceMicros());
+  for (uint8_t i = 0; i < argc; i++) n += putSigned(buf + n, args[i]);
+
+  uint8_t sum = 0;
+  for (uint8_t i = 2; i < n; i++) sum += buf[i];
+
+  buf[0] = LOG_RECORD_TAG;
+  buf[1] = n - 2;
+  buf[n++] = sum;
+  Link.write(buf, n);  // 한 번에 보내 프레임 중간에 끼지 않게
+}
+#else
+static const char* const LOG_FORMATS[LOG_MSG_COUNT] = {
+#define LOGMSG(id, level, fmt) fmt,
+#include "logmsg.h"
+#undef LOGMSG
+};
+
+void logWrite(LogMsgId id, uint8_t level, const long* args, uint8_t argc) {
+  (void)level;
+  uint8_t used = 0;
+
+  for (const char* p = LOG_FORMATS[id]; *p; p++) {
+    if (p[0] == '%' && p[1] == 'd' && used < argc) {
+      Link.print(args[used++]);
+      p++;
+    } else {
+      Link.write((uint8_t)*p);
+    }
+  }
+  Link.println();
+}
+#endif
@@ -0,0 +1,65 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// =======================================================
+// === 바이너리 로그 채널 (메시지 ID + 정수 인자)
+// =======================================================
+// 사람이 읽는 문자열 대신 logmsg.h 의 메시지 ID 와 정수 인자만 작은 레코드로 보낸다.
+// 문자열은 펌웨어에 들어가지 않고, 호스트 도구가 같은 logmsg.h 로 복원한다.
+//
+// 레코드 (JSON 프레임 사이에 끼어도 구분되도록 0x1F 로 시작, 텍스트에 나오지 않는 값):
+//   [0]     0x1F        LOG_RECORD_TAG
+//   [1]     len         [2] 부터 체크섬 앞까지의 바이트 수
+//   [2..3]  id          메시지 ID (little endian)
+//   [4]     level<<4 | argc
+//   [5..]   ts          기기 시각 µs (devclock.h), varint
+//   [..]    args        zigzag varint (인자당 1~5 바이트)
+//   [last]  sum         [2] 부터 args 끝까지 바이트 합 (하위 8비트)
+//
+// LOG_LEVEL_MIN (config.h) 보다 낮은 레벨의 LOG() 는 컴파일 단계에서 빠진다.
+// LOG_TEXT 를 정의하면 레코드 대신 문자열로 풀어 한 줄씩 보낸다 (시리얼 모니터 디버깅용).
+
+enum LogLevel : uint8_t {
+  LOG_DEBUG = 0,
+  LOG_INFO  = 1,
+  LOG_WARN  = 2,
+  LOG_ERROR = 3,
+};
+
+enum LogMsgId : uint16_t {
+#define LOGMSG(id, level, fmt) id,
+#include "logmsg.h"
+#undef LOGMSG
+  LOG_MSG_COUNT
+};
+
+// 메시지별 레벨 (LOG() 가 컴파일 시점에 비교)
+enum {
+#define LOGMSG(id, level, fmt) LOG_LEVEL_OF_##id = level,
+#include "logmsg.h"
+#undef LOGMSG
+};
+
+const uint8_t LOG_RECORD_TAG = 0x1F;
+const uint8_t LOG_MAX_ARGS   = 4;
+
+void logWrite(LogMsgId id, uint8_t level, const long* args, uint8_t argc);
+
+template <typename... Args>
+inline void logEmit(LogMsgId id, uint8_t level, Args... args) {
+  static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+  const long a[] = { (long)args..., 0 };
+  logWrite(id, level, a, sizeof...(Args));
+}
+
+// 예: LOG(MSG_CUP_DISPENSE_START, idx + 1);
+#define LOG(id, ...)                                                   \
+  do {                                                                 \
+    if (LOG_LEVEL_OF_##id >= LOG_LEVEL_MIN)                            \
+      logEmit(id, LOG_LEVEL_OF_##id, ##__VA_ARGS__);                   \
+  } while (0)
+
+#endif // LOG_H
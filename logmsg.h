@@ -0,0 +1,80 @@
+// =======================================================
+// === 로그 메시지 목록 (메시지 ID 표)
+// =======================================================
+// LOGMSG(ID, 레벨, "형식")  -  형식의 %d 는 순서대로 정수 인자로 치환된다.
+// 펌웨어는 ID 와 인자만 보내고, 문자열은 호스트 도구(host/logdecode, gateway)가
+// 이 파일을 그대로 include 하여 만든 표로 복원한다.
+// ID 는 순서로 매겨지므로 항목은 항상 끝에 추가한다 (중간 삽입/삭제 금지).
+// X-매크로 목록이라 include 가드가 없다 (include 하는 쪽이 LOGMSG 를 정의).
+
+// --- 설정
+LOGMSG(MSG_PINS_CONFIGURED,        LOG_INFO,  "pins configured")
+LOGMSG(MSG_RAMEN_SETUP_IDX,        LOG_DEBUG, "ramen setup idx : %d")
+LOGMSG(MSG_OUTLET_SCALE_READY,     LOG_INFO,  "Outlet Scale %d ready.")
+LOGMSG(MSG_OUTLET_SCALE_NOT_FOUND, LOG_WARN,  "Outlet Scale %d NOT FOUND.")
+LOGMSG(MSG_OUTLET_SETUP_DONE,      LOG_DEBUG, "setup outlet complete!")
+
+// --- 용기
+LOGMSG(MSG_CUP_DISPENSE_START,     LOG_INFO,  "명령: 용기 배출 시작 (장비: %d)")
+LOGMSG(MSG_CUP_DISPENSE_DONE,      LOG_INFO,  "완료: 용기 배출 중지 (장비: %d)")
+
+// --- 면
+LOGMSG(MSG_RAMEN_RISE_START,       LOG_INFO,  "명령: 면 상승 시작 (장비: %d)")
+LOGMSG(MSG_RAMEN_RISE_PHOTO,       LOG_DEBUG, "포토 센서 LOW (Debounced)")
+LOGMSG(MSG_RAMEN_RISE_TOP,         LOG_DEBUG, "면상승 상한센서 HIGH")
+LOGMSG(MSG_RAMEN_RISE_DONE,        LOG_INFO,  "완료: 상승 동작 중지 (장비: %d)")
+LOGMSG(MSG_RAMEN_INIT_START,       LOG_INFO,  "명령: 면 하강 시작 (장비: %d)")
+LOGMSG(MSG_RAMEN_INIT_DONE,        LOG_INFO,  "완료: 하강 동작 중지 (장비: %d)")
+LOGMSG(MSG_RAMEN_EJECT_START,      LOG_INFO,  "명령: 면 배출 시작 (장비: %d)")
+LOGMSG(MSG_RAMEN_EJECT_BUSY,       LOG_WARN,  "Warning: Eject command ignored. Status is not IDLE. (장비: %d)")
+LOGMSG(MSG_RAMEN_EJECT_TOP,        LOG_INFO,  "상태: 배출 상한 도달. 복귀 시작 (장비: %d)")
+LOGMSG(MSG_RAMEN_EJECT_DONE,       LOG_INFO,  "완료: 상승 하한 감지. 배출 복귀 모터 정지 (장비: %d)")
+
+// --- 스프
+LOGMSG(MSG_POWDER_DISPENSE_START,  LOG_INFO,  "명령: 스프 배출 시작 (장비: %d, 시간: %dms)")
+LOGMSG(MSG_POWDER_DISPENSE_DONE,   LOG_INFO,  "완료: 시간 경과. 스프 배출 중지 (장비: %d)")
+
+// --- 배출구
+LOGMSG(MSG_OUTLET_OPEN_START,      LOG_INFO,  "명령: 배출구 오픈 시작 (장비: %d)")
+LOGMSG(MSG_OUTLET_CLOSE_START,     LOG_INFO,  "명령: 배출구 닫기 시작 (장비: %d)")
+LOGMSG(MSG_OUTLET_OPEN_DONE,       LOG_INFO,  "완료: 배출구 오픈 완료 (장비: %d)")
+LOGMSG(MSG_OUTLET_CLOSE_DONE,      LOG_INFO,  "완료: 배출구 닫힘 완료 (장비: %d)")
+
+// --- 명령 수신 확인
+LOGMSG(MSG_CMD_CUP_START,          LOG_DEBUG, "cup startdispense")
+LOGMSG(MSG_CMD_CUP_STOP,           LOG_DEBUG, "cup stopdispense")
+LOGMSG(MSG_CMD_CUP_UNKNOWN,        LOG_WARN,  "unknown cup function")
+LOGMSG(MSG_CMD_RAMEN_HANDLE,       LOG_DEBUG, "start handle ramen")
+LOGMSG(MSG_CMD_RAMEN_START,        LOG_DEBUG, "ramen startdispense")
+LOGMSG(MSG_CMD_RAMEN_READY,        LOG_DEBUG, "ramen readydispense")
+LOGMSG(MSG_CMD_RAMEN_INIT,         LOG_DEBUG, "ramen initdispense")
+LOGMSG(MSG_CMD_RAMEN_STOP,         LOG_DEBUG, "ramen stopdispense (ALL STOP)")
+LOGMSG(MSG_CMD_POWDER_START,       LOG_DEBUG, "powder startdispense (장비: %d, 시간: %d ms)")
+LOGMSG(MSG_CMD_POWDER_STOP,        LOG_DEBUG, "powder stopdispense")
+LOGMSG(MSG_CMD_COOKER_START,       LOG_DEBUG, "cooker startcook")
+LOGMSG(MSG_CMD_COOKER_STOP,        LOG_DEBUG, "cooker stopcook")
+LOGMSG(MSG_CMD_OUTLET_OPEN,        LOG_DEBUG, "outlet opendoor")
+LOGMSG(MSG_CMD_OUTLET_CLOSE,       LOG_DEBUG, "outlet closedoor")
+LOGMSG(MSG_CMD_OUTLET_STOP,        LOG_DEBUG, "outlet stopoutlet")
+
+// --- 기타
+LOGMSG(MSG_VOLTAGE,                LOG_DEBUG, "current vol : %d")
+
+// --- 조리
+LOGMSG(MSG_COOK_START,             LOG_INFO,  "명령: 조리 시작 (장비: %d, 물: %dml, 시간: %ds)")
+LOGMSG(MSG_COOK_FILL_DONE,         LOG_INFO,  "상태: 급수 완료. 가열 시작 (장비: %d)")
+LOGMSG(MSG_COOK_DONE,              LOG_INFO,  "완료: 조리 시간 경과. 가열 중지 (장비: %d)")
+
+// --- 스프 정량 배출
+LOGMSG(MSG_POWDER_DOSE_START,      LOG_INFO,  "명령: 스프 정량 배출 시작 (장비: %d, 목표: %dmg, 예상: %dms)")
+LOGMSG(MSG_POWDER_DOSE_DONE,       LOG_INFO,  "완료: 스프 정량 배출 (장비: %d, 추정: %dmg, 시간: %dms)")
+LOGMSG(MSG_POWDER_DOSE_SHORT,      LOG_WARN,  "경고: 스프 배출 부족 정지 (장비: %d, 추정: %dmg / 목표: %dmg)")
+LOGMSG(MSG_POWDER_MODEL,           LOG_INFO,  "상태: 스프 유량 모델 갱신 (장비: %d, 유량: %dmg/s, 기준 부하: %d)")
+
+// --- 용기 연속 배출
+LOGMSG(MSG_CUP_QUEUE_DONE,         LOG_INFO,  "완료: 용기 배출 큐 종료 (채널: %d, 배출: %d개)")
+
+// --- 배출구 그릇 전달
+LOGMSG(MSG_OUTLET_PLACED,          LOG_INFO,  "상태: 배출구 그릇 놓임. 문 열기 (장비: %d, 무게: %d)")
+LOGMSG(MSG_OUTLET_PICKUP,          LOG_INFO,  "완료: 배출구 그릇 가져감. 문 닫기 (장비: %d, 대기: %dms)")
+LOGMSG(MSG_OUTLET_REPLACED,        LOG_WARN,  "경고: 닫는 중 그릇 다시 놓임. 문 다시 열기 (장비: %d)")
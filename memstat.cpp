@@ -0,0 +1,122 @@
+#include <Arduino.h>
+#include "memstat.h"
+#include "config.h"
+#include "frame.h"
+#include "transport.h"
+#include "devclock.h"
+
+#ifdef ARDUINO_ARCH_SAM
+#include <malloc.h>
+extern "C" char* sbrk(int incr);
+extern "C" uint32_t _estack;  // 스택 맨 위 (startup_sam3xa.c 의 초기 SP)
+#endif
+
+static uint16_t rxPeak = 0;         // 명령 버퍼 최대 점유 (바이트)
+static uint16_t rxBacklogPeak = 0;  // 드라이버 수신 대기 최대 (바이트)
+static uint16_t txPeak = 0;         // 송신 큐 최대 적체 (바이트)
+static unsigned long txMaxUs = 0;   // 송신 큐가 넘쳐 막힌 최대 시간
+static unsigned long lastMemReportMs = 0;
+
+#ifdef ARDUINO_ARCH_SAM
+static const uint32_t MEM_PAINT = 0xA5A5A5A5;
+static const uint8_t MEM_PAINT_MARGIN_WORDS = 16;  // 칠하는 함수 자신의 프레임 보호
+
+static uint32_t* paintLow = nullptr;  // 칠한 아래 끝 (부팅 때 힙 끝)
+static uint32_t* stackLow = nullptr;  // 지금까지 지워진 가장 깊은 위치
+
+static uint32_t* wordAlignUp(void* p) {
+  return (uint32_t*)(((uintptr_t)p + 3) & ~(uintptr_t)3);
+}
+
+static uint32_t* currentSp() {
+  uint32_t* sp;
+  asm volatile("mov %0, sp" : "=r"(sp));
+  return sp;
+}
+
+// 스택 최대 사용량: 이전에 찾은 위치 아래만 다시 훑는다 (스택은 깊어지기만 함)
+static uint32_t stackHighWater() {
+  uint32_t* p = wordAlignUp(sbrk(0));
+  if (p < paintLow) p = paintLow;
+  if (p < stackLow) {
+    while (p < stackLow && *p == MEM_PAINT) p++;
+    stackLow = p;
+  }
+  return (uint32_t)((char*)&_estack - (char*)stackLow);
+}
+#endif
+
+void initMemStats() {
+#ifdef ARDUINO_ARCH_SAM
+  uint32_t* p = wordAlignUp(sbrk(0));
+  uint32_t* top = currentSp() - MEM_PAINT_MARGIN_WORDS;
+  paintLow = p;
+  while (p < top) *p++ = MEM_PAINT;
+  stackLow = top;
+#endif
+}
+
+void noteRxBacklog(int pending) {
+  if (pending > (int)rxBacklogPeak) rxBacklogPeak = (pending > 0xFFFF) ? 0xFFFF : pending;
+}
+
+void noteRxLen(size_t len) {
+  if (len > rxPeak) rxPeak = len;
+}
+
+void noteTxBacklog(size_t queued) {
+  if (queued > txPeak) txPeak = (queued > 0xFFFF) ? 0xFFFF : queued;
+}
+
+void noteTxBlock(unsigned long us) {
+  if (us > txMaxUs) txMaxUs = us;
+}
+
+void sendMemStats() {
+  uint32_t stack = 0, heapUsed = 0, holes = 0, freeBytes = 0;
+#ifdef ARDUINO_ARCH_SAM
+  stack = stackHighWater();
+  struct mallinfo mi = mallinfo();
+  heapUsed = mi.uordblks;
+  holes = mi.fordblks;
+  freeBytes = (uint32_t)((char*)currentSp() - (char*)sbrk(0)) + holes;
+#endif
+  uint32_t frag = freeBytes ? (holes * 100UL) / freeBytes : 0;
+
+  char buf[256];
+  FrameWriter w(buf, sizeof(buf));
+  w.lit("[{\"device\":\"mem\",\"stack\":");
+  w.uinteger(stack);
+  w.lit(",\"heap\":");
+  w.uinteger(heapUsed);
+  w.lit(",\"holes\":");
+  w.uinteger(holes);
+  w.lit(",\"free\":");
+  w.uinteger(freeBytes);
+  w.lit(",\"frag\":");
+  w.uinteger(frag);
+  w.lit(",\"rx\":[");
+  w.uinteger(rxPeak);
+  w.raw(',');
+  w.uinteger(RX_BUFFER_SIZE);
+  w.lit("],\"rxq\":");
+  w.uinteger(rxBacklogPeak);
+  w.lit(",\"tx\":");
+  w.uinteger(txPeak);
+  w.lit(",\"tx_us\":");
+  w.uinteger(txMaxUs);
+  w.lit(",\"ts\":");
+  w.uinteger64(deviceMicros());
+  w.lit("}]\r\n");
+  w.flushTo(Link);
+}
+
+void reportMemStats() {
+  if (MEM_REPORT_INTERVAL_MS == 0) return;
+
+  unsigned long now = millis();
+  if (now - lastMemReportMs >= MEM_REPORT_INTERVAL_MS) {
+    lastMemReportMs = now;
+    sendMemStats();
+  }
+}
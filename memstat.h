@@ -0,0 +1,34 @@
+#ifndef MEMSTAT_H
+#define MEMSTAT_H
+
+#include <Arduino.h>
+
+// =======================================================
+// === 메모리 / 버퍼 사용량 (장시간 운전 시 누수, 버퍼 크기 결정용)
+// =======================================================
+// - 스택: 부팅 시 힙 끝 ~ 현재 SP 사이를 무늬(MEM_PAINT)로 칠해 두고,
+//         지워진 가장 깊은 위치로 최대 사용량(high-water)을 구한다.
+// - 힙  : newlib mallinfo (사용 중 / 힙 안의 빈 조각) 와 힙 끝 ~ SP 사이 여유.
+//         frag 는 전체 여유 중 힙 안의 빈 조각 비율(%) - 클수록 조각남.
+// - RX  : 명령 버퍼(rx) 최대 점유, 드라이버 수신 대기 바이트 최대값
+// - TX  : 송신 큐(Link) 최대 적체 바이트, 큐가 넘쳐 write 가 막힌 가장 긴 시간
+// 스택 / 힙 값은 SAM (Due) 빌드에서만 재고, 호스트 빌드는 0 으로 보고한다.
+
+// setup() 맨 앞에서 1회 (스택 칠하기)
+void initMemStats();
+
+// rx 작업: 드라이버 수신 대기 바이트 / 명령 버퍼 점유
+void noteRxBacklog(int pending);
+void noteRxLen(size_t len);
+
+// 송신 큐: 쌓인 바이트 / 자리가 날 때까지 막힌 시간
+void noteTxBacklog(size_t queued);
+void noteTxBlock(unsigned long us);
+
+// {"device":"mem",...} 프레임 전송 (query 응답)
+void sendMemStats();
+
+// MEM_REPORT_INTERVAL_MS 마다 전송 (0 이면 끔)
+void reportMemStats();
+
+#endif // MEMSTAT_H
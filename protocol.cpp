@@ -1,43 +1,62 @@
 #include <Arduino.h>
-#include <ArduinoJson.h>
-#include "Protocol.h"  // 자신의 헤더
+#include "protocol.h"  // 자신의 헤더
 #include "config.h"    // 핀맵
+#if JSON_FALLBACK
+#include <ArduinoJson.h>
+#endif
 #include "state.h"     // 전역 변수(current, state) 사용
 #include "reporting.h"
+#include "command.h"
+#include "frame.h"
+#include "log.h"
+#include "devclock.h"
+#include "transport.h"
+#include "supervisor.h"
+#include "scheduler.h"
+#include "limitstop.h"
+#include "dosing.h"
+#include "sensestat.h"
+#include "memstat.h"
 #include "HX711.h"
 
 HX711 outletScale[4] = {};
+OutletLane outletLanes[MAX_OUTLET];
 
-RamenEjectState ramenEjectStatus = EJECT_IDLE;
+RamenEjectState ramenEjectStatus[MAX_RAMEN] = { EJECT_IDLE };
 
 bool isPowderDispensing[MAX_POWDER] = { false };
 unsigned long powderStartTime[MAX_POWDER] = { 0 };
 unsigned long powderDuration[MAX_POWDER] = { 0 };
 
-long startCupReleaseTime[MAX_CUP] = {0};
-long cupReleaseInterval = 500;
+CookProgram cookers[MAX_COOKER];
+
+unsigned long startCupReleaseTime[MAX_CUP] = {0};
+unsigned long cupReleaseInterval = 500;
 
 // =======================================================
 // === 1. 설정 (Setup) 및 파싱 (Parse) 함수
 // =======================================================
 
 void replyCurrentSetting(const Setting& s) {
-  StaticJsonDocument<256> doc;
-  doc["device"] = "setting";
-  if (s.cup) doc["cup"] = s.cup;
-  if (s.ramen) doc["ramen"] = s.ramen;
-  if (s.powder) doc["powder"] = s.powder;
-  if (s.cooker) doc["cooker"] = s.cooker;
-  if (s.outlet) doc["outlet"] = s.outlet;
+  char buf[96];
+  FrameWriter w(buf, sizeof(buf));
 
   // 수정: 대괄호로 감싸서 전송
-  Serial.print('[');
-  serializeJson(doc, Serial);
-  Serial.println(']');
+  w.lit("[{\"device\":\"setting\"");
+  if (s.cup) { w.lit(",\"cup\":"); w.integer(s.cup); }
+  if (s.ramen) { w.lit(",\"ramen\":"); w.integer(s.ramen); }
+  if (s.powder) { w.lit(",\"powder\":"); w.integer(s.powder); }
+  if (s.cooker) { w.lit(",\"cooker\":"); w.integer(s.cooker); }
+  if (s.outlet) { w.lit(",\"outlet\":"); w.integer(s.outlet); }
+  w.lit(",\"ts\":");
+  w.uinteger64(deviceMicros());
+  w.lit("}]\r\n");
+  w.flushTo(Link);
 }
 
 // ===== 핀모드 설정 (Count 기반 복구) =====
 void setupCup(uint8_t n) {
+  resetCupQueues();
   for (uint8_t i = 0; i < n; i++) {
     pinMode(CUP_MOTOR_OUT[i], OUTPUT);
     pinMode(CUP_ROT_IN[i], INPUT_PULLUP);
@@ -47,8 +66,7 @@ void setupCup(uint8_t n) {
 }
 void setupRamen(uint8_t n) {
   for (uint8_t i = 0; i < n; i++) {
-    Serial.print("ramen setup idx : ");
-    Serial.println(i);
+    LOG(MSG_RAMEN_SETUP_IDX, i);
 
     pinMode(RAMEN_UP_FWD_OUT[i], OUTPUT);
     pinMode(RAMEN_UP_REV_OUT[i], OUTPUT);
@@ -59,6 +77,7 @@ void setupRamen(uint8_t n) {
     pinMode(RAMEN_UP_TOP_IN[i], INPUT_PULLUP);
     pinMode(RAMEN_UP_BTM_IN[i], INPUT_PULLUP);
     pinMode(RAMEN_PRESENT_IN[i], INPUT_PULLUP);
+    ramenEjectStatus[i] = EJECT_IDLE;
   }
 
   // [수정] 모든 RAMEN_ENCODER 핀 설정 (i 인덱스 사용)
@@ -70,6 +89,7 @@ void setupPowder(uint8_t n) {
   for (uint8_t i = 0; i < n; i++) {
     pinMode(POWDER_MOTOR_OUT[i], OUTPUT);
   }
+  loadPowderModels();
 }
 
 void setupOutlet(uint8_t n) {
@@ -80,35 +100,35 @@ void setupOutlet(uint8_t n) {
     pinMode(OUTLET_REV_OUT[i], OUTPUT);
     pinMode(OUTLET_OPEN_IN[i], INPUT_PULLUP);
     pinMode(OUTLET_CLOSE_IN[i], INPUT_PULLUP);
+    outletLanes[i] = OutletLane();
 
     outletScale[i].begin(OUTLET_LOAD_AIN[i], OUTLET_USONIC_AIN[i]);
     outletScale[i].set_scale(10.f);
     
     if (outletScale[i].wait_ready_timeout(500)) {
         outletScale[i].tare(10);
-        Serial.print("Outlet Scale "); Serial.print(i); Serial.println(" ready.");
+        LOG(MSG_OUTLET_SCALE_READY, i);
     } else {
-        Serial.print("Outlet Scale "); Serial.print(i); Serial.println(" NOT FOUND.");
+        LOG(MSG_OUTLET_SCALE_NOT_FOUND, i);
     }
+    feedWatchdog();  // 로드셀 tare 가 길어 watchdog 갱신
 
-    Serial.println("setup outlet complete!");
+    LOG(MSG_OUTLET_SETUP_DONE);
   }
 }
 
 void setupCooker(uint8_t n) {
   for (uint8_t i = 0; i < n; i++) {
-    if (i < 2) {
-      pinMode(COOKER_IND_SIG[i], OUTPUT);
-      pinMode(COOKER_WTR_SIG[i], OUTPUT);
-    } else {
-      pinMode(COOKER_IND_SIG[i], INPUT);
-      pinMode(COOKER_WTR_SIG[i], INPUT);
-    }
+    cookers[i] = CookProgram();
+    pinMode(COOKER_IND_SIG[i], OUTPUT);
+    pinMode(COOKER_WTR_SIG[i], OUTPUT);
+    digitalWrite(COOKER_IND_SIG[i], LOW);
+    digitalWrite(COOKER_WTR_SIG[i], LOW);
   }
 }
 
 // ===== 설정 적용 및 검증 (Setting 시 호출) =====
-bool validateRules(const Setting& s, String& why) {
+bool validateRules(const Setting& s, const char*& why) {
   uint8_t nonzeroCnt = (s.cup ? 1 : 0) + (s.ramen ? 1 : 0) + (s.powder ? 1 : 0) + (s.cooker ? 1 : 0) + (s.outlet ? 1 : 0);
   if (s.cup > MAX_CUP) {
     why = "cup max=4";
@@ -122,8 +142,8 @@ bool validateRules(const Setting& s, String& why) {
     why = "powder max=8";
     return false;
   }
-  if (s.cooker > MAX_COOKER) {
-    why = "cooker max=8";
+  if (s.cooker > COOKER_WIRED) {
+    why = "cooker max=2 (wired)";  // 핀맵이 있는 조리기만
     return false;
   }
   if (s.outlet > MAX_OUTLET) {
@@ -150,48 +170,183 @@ void applySetting(const Setting& s) {
   if (s.powder) setupPowder(s.powder);
   if (s.outlet) setupOutlet(s.outlet);
   if (s.cooker) setupCooker(s.cooker);
+  attachLimitInterrupts(s);  // 리밋 도달 시 ISR 에서 바로 출력 차단
   current = s;  // 전역 변수 'current'에 적용
+  resetSenseStats();  // 구성이 바뀌었으니 구간 통계 새로 시작
 }
 
 // =======================================================
 // === 2. 비동기 제어 함수 (Start / Check)
 // =======================================================
 
-void startCupDispense(uint8_t idx) {
-  Serial.print("명령: 용기 배출 시작 (장비: ");
-  Serial.print(idx + 1);
-  Serial.println(")");
-  digitalWrite(CUP_MOTOR_OUT[idx], HIGH);
+// ===== 용기 배출 큐 =====
+// 채널(control)마다 남은 개수를 쌓아두고 한 개씩 연속으로 배출한다.
+// 채널의 자기 유닛이 비면(CUP_STOCK_IN) 재고 있는 다른 유닛으로 넘어간다.
+enum CupUnitState {
+  CUP_UNIT_IDLE,
+  CUP_UNIT_RUNNING,   // 모터 동작, owner 채널의 1개 배출 중
+  CUP_UNIT_GAP,       // 연속 배출 사이 정지 (gapUntil 까지)
+  CUP_UNIT_JAMMED     // 배출 마감 초과: stopdispense / setting 전까지 사용 안 함
+};
+
+struct CupUnit {
+  CupUnitState state = CUP_UNIT_IDLE;
+  uint8_t owner = 0;          // 배출 중인 채널
+  unsigned long gapUntil = 0;
+};
+
+struct CupQueue {
+  uint16_t pending = 0;       // 남은 개수
+  uint16_t served = 0;        // 이번 요청에서 배출한 개수
+  bool running = false;       // 유닛 하나에서 배출 중
+};
+
+static CupUnit cupUnits[MAX_CUP];
+static CupQueue cupQueues[MAX_CUP];
+
+static bool cupHasStock(uint8_t u) {
+  return digitalRead(CUP_STOCK_IN[u]) != CUP_STOCK_EMPTY_LEVEL;
+}
+
+static bool cupUnitReady(uint8_t u, unsigned long now) {
+  const CupUnit& unit = cupUnits[u];
+  if (unit.state == CUP_UNIT_GAP) return (long)(now - unit.gapUntil) >= 0;
+  return unit.state == CUP_UNIT_IDLE;
+}
+
+// 배출 마감 초과 (supervisor 가 모터는 이미 끔): 유닛을 제외하고 큐는 다른 유닛으로 계속
+static void abortCupCycle(uint8_t u) {
+  CupUnit& unit = cupUnits[u];
+  if (unit.state == CUP_UNIT_RUNNING) cupQueues[unit.owner].running = false;
+  unit.state = CUP_UNIT_JAMMED;
+}
+
+static void startCupCycle(uint8_t u, uint8_t ch) {
+  LOG(MSG_CUP_DISPENSE_START, u + 1);
+  cupUnits[u].state = CUP_UNIT_RUNNING;
+  cupUnits[u].owner = ch;
+  cupQueues[ch].running = true;
+  startCupReleaseTime[u] = millis();
+  digitalWrite(CUP_MOTOR_OUT[u], HIGH);
+  superviseMotion(CUP_MOTOR_OUT[u], "cup", u, "dispense", CUP_DISPENSE_TIMEOUT_MS, abortCupCycle);
+}
+
+static void finishCupQueue(uint8_t ch, const char* event, const char* key, long value) {
+  cupQueues[ch].pending = 0;
+  sendEvent("cup", ch + 1, event, key, value);
+  LOG(MSG_CUP_QUEUE_DONE, ch + 1, cupQueues[ch].served);
+}
+
+/**
+ * @brief 채널 ch 에 count 개 배출 요청을 추가
+ */
+void queueCupDispense(uint8_t ch, uint16_t count) {
+  CupQueue& q = cupQueues[ch];
+  if (q.pending == 0) q.served = 0;
+  q.pending = (q.pending + count > CUP_QUEUE_MAX) ? CUP_QUEUE_MAX : q.pending + count;
+}
+
+/**
+ * @brief 채널 ch 의 남은 요청 취소, 배출 중인 유닛 정지
+ */
+void cancelCupQueue(uint8_t ch) {
+  cupQueues[ch].pending = 0;
+  cupQueues[ch].running = false;
+  for (uint8_t u = 0; u < current.cup; u++) {
+    if (cupUnits[u].state == CUP_UNIT_RUNNING && cupUnits[u].owner == ch) {
+      digitalWrite(CUP_MOTOR_OUT[u], LOW);
+      releaseMotion(CUP_MOTOR_OUT[u]);
+      cupUnits[u].state = CUP_UNIT_IDLE;
+    }
+  }
+}
+
+// 유닛 u 강제 정지 (stopdispense, 걸림 해제 포함). 다른 채널이 이 유닛으로 배출 중이었으면
+// 그 채널의 이번 1개는 실패로 알리고 ("failed", unit) 남은 큐는 다른 배출로 계속한다.
+static void stopCupUnit(uint8_t u) {
+  CupUnit& unit = cupUnits[u];
+  digitalWrite(CUP_MOTOR_OUT[u], LOW);
+  releaseMotion(CUP_MOTOR_OUT[u]);
+
+  if (unit.state == CUP_UNIT_RUNNING) {
+    CupQueue& q = cupQueues[unit.owner];
+    q.running = false;
+    if (q.pending) q.pending--;
+    sendEvent("cup", unit.owner + 1, "failed", "unit", u + 1);
+    if (q.pending == 0) finishCupQueue(unit.owner, "drained", "served", q.served);
+  }
+  unit.state = CUP_UNIT_IDLE;
+}
+
+/**
+ * @brief 모든 큐 / 유닛 상태 초기화 (setting 시, 걸림 해제 포함)
+ */
+void resetCupQueues() {
+  for (uint8_t i = 0; i < MAX_CUP; i++) {
+    cupUnits[i] = CupUnit();
+    cupQueues[i] = CupQueue();
+  }
+}
+
+int cupQueueLength(uint8_t ch) {
+  return cupQueues[ch].pending;
 }
 
 void checkCupDispense() {
-    for (uint8_t i = 0; i < current.cup; i++) {
-      if (digitalRead(CUP_MOTOR_OUT[i]) == HIGH) {
-        if (startCupReleaseTime[i] == 0) {
-          startCupReleaseTime[i] = millis();
-        }
+  unsigned long now = millis();
+  uint8_t i;
 
-        long now = millis();
-        long elapsedTime = now - startCupReleaseTime[i];
-        if (elapsedTime >= cupReleaseInterval) {
-          if (digitalRead(CUP_DISP_IN[i]) == LOW) {
-          Serial.print("완료: 용기 배출 중지 (장비: ");
-          Serial.print(i + 1);
-          Serial.println(")");
-          digitalWrite(CUP_MOTOR_OUT[i], LOW);
+  // 1. 배출 중인 유닛의 완료 확인
+  for (i = 0; i < current.cup; i++) {
+    CupUnit& unit = cupUnits[i];
+
+    // ISR 이 이미 정지시킨 경우: 완료 처리만
+    bool stoppedByIsr = takeLimitStop(CUP_MOTOR_OUT[i]);
+    if (unit.state != CUP_UNIT_RUNNING) continue;
+
+    // unsigned 차이로 계산하여 millis() 넘어감에도 안전
+    unsigned long elapsedTime = now - startCupReleaseTime[i];
+    if (stoppedByIsr || (elapsedTime >= cupReleaseInterval && digitalRead(CUP_DISP_IN[i]) == LOW)) {
+      LOG(MSG_CUP_DISPENSE_DONE, i + 1);
+      digitalWrite(CUP_MOTOR_OUT[i], LOW);
+      releaseMotion(CUP_MOTOR_OUT[i]);
+
+      unit.state = CUP_UNIT_GAP;
+      unit.gapUntil = now + CUP_CYCLE_GAP_MS;
+
+      CupQueue& q = cupQueues[unit.owner];
+      q.running = false;
+      if (q.pending) q.pending--;
+      q.served++;
+      sendEvent("cup", unit.owner + 1, "dispensed", "unit", i + 1);
+      if (q.pending == 0) finishCupQueue(unit.owner, "drained", "served", q.served);
+    }
+  }
 
-          startCupReleaseTime[i] = 0;
-        }
-      }
+  // 2. 대기 중인 채널에 유닛 배정: 재고 있는 유닛 중 자기 유닛부터 차례로 첫 번째.
+  //    그 유닛이 바쁘면(정지 간격, 다른 채널 배출 중) 비워질 때까지 기다린다.
+  for (uint8_t ch = 0; ch < current.cup; ch++) {
+    CupQueue& q = cupQueues[ch];
+    if (q.pending == 0 || q.running) continue;
+
+    bool anyStock = false;
+    for (uint8_t k = 0; k < current.cup; k++) {
+      uint8_t u = (ch + k) % current.cup;
+      if (cupUnits[u].state == CUP_UNIT_JAMMED || !cupHasStock(u)) continue;
+      anyStock = true;
+      if (cupUnitReady(u, now)) startCupCycle(u, ch);
+      break;
     }
+
+    // 쓸 수 있는 모든 유닛에 재고 없음: 남은 개수 알리고 종료
+    if (!anyStock) finishCupQueue(ch, "stockout", "left", q.pending);
   }
 }
 
 void startRamenRise(uint8_t idx) {
-  Serial.print("명령: 면 상승 시작 (장비: ");
-  Serial.print(idx + 1);
-  Serial.println(")");
+  LOG(MSG_RAMEN_RISE_START, idx + 1);
   digitalWrite(RAMEN_UP_FWD_OUT[idx], HIGH);
+  superviseMotion(RAMEN_UP_FWD_OUT[idx], "ramen", idx, "rise", RAMEN_LIFT_TIMEOUT_MS);
 }
 
 void checkRamenRise() {
@@ -201,7 +356,12 @@ void checkRamenRise() {
   int stableState;
 
   for (i = 0; i < current.ramen; i++) {
-    if (digitalRead(RAMEN_UP_FWD_OUT[i]) == HIGH) {
+    if (takeLimitStop(RAMEN_UP_FWD_OUT[i])) {
+      // 상한 리밋 ISR 이 이미 정지
+      LOG(MSG_RAMEN_RISE_TOP);
+      LOG(MSG_RAMEN_RISE_DONE, i + 1);
+      releaseMotion(RAMEN_UP_FWD_OUT[i]);
+    } else if (digitalRead(RAMEN_UP_FWD_OUT[i]) == HIGH) {
       bool stopMotor = false;
       currentReading = digitalRead(RAMEN_PRESENT_IN[i]);
       if (currentReading != ramenPhotoPrevState[i]) {
@@ -215,19 +375,18 @@ void checkRamenRise() {
         stableState = ramenPhotoPrevState[i];
       }
       if (stableState == LOW) {
-        Serial.println("포토 센서 LOW (Debounced)");
+        LOG(MSG_RAMEN_RISE_PHOTO);
         stopMotor = true;
       } 
       else if (digitalRead(RAMEN_UP_TOP_IN[i]) == HIGH) {
-        Serial.println("면상승 상한센서 HIGH");
+        LOG(MSG_RAMEN_RISE_TOP);
         stopMotor = true;
       }
 
       if (stopMotor) {
-        Serial.print("완료: 상승 동작 중지 (장비: ");
-        Serial.print(i + 1);
-        Serial.println(")");
+        LOG(MSG_RAMEN_RISE_DONE, i + 1);
         digitalWrite(RAMEN_UP_FWD_OUT[i], LOW);
+        releaseMotion(RAMEN_UP_FWD_OUT[i]);
       }
     }
   }
@@ -237,10 +396,9 @@ void checkRamenRise() {
  * @brief 
  */
 void startRamenInit(uint8_t idx) {
-  Serial.print("명령: 면 하강 시작 (장비: ");
-  Serial.print(idx + 1);
-  Serial.println(")");
+  LOG(MSG_RAMEN_INIT_START, idx + 1);
   digitalWrite(RAMEN_UP_REV_OUT[idx], HIGH);
+  superviseMotion(RAMEN_UP_REV_OUT[idx], "ramen", idx, "init", RAMEN_LIFT_TIMEOUT_MS);
 }
 
 /**
@@ -248,90 +406,99 @@ void startRamenInit(uint8_t idx) {
  */
 void checkRamenInit() {
   for (uint8_t i = 0; i < current.ramen; i++) {
-    if (digitalRead(RAMEN_UP_REV_OUT[i]) == HIGH) {
-      if (digitalRead(RAMEN_UP_BTM_IN[i]) == HIGH) {
-        Serial.print("완료: 하강 동작 중지 (장비: ");
-        Serial.print(i + 1);
-        Serial.println(")");
+    bool stoppedByIsr = takeLimitStop(RAMEN_UP_REV_OUT[i]);
+    if (stoppedByIsr || digitalRead(RAMEN_UP_REV_OUT[i]) == HIGH) {
+      if (stoppedByIsr || digitalRead(RAMEN_UP_BTM_IN[i]) == HIGH) {
+        LOG(MSG_RAMEN_INIT_DONE, i + 1);
         digitalWrite(RAMEN_UP_REV_OUT[i], LOW);
+        releaseMotion(RAMEN_UP_REV_OUT[i]);
       }
     }
   }
 }
 
+// 배출 전진/복귀 마감 초과 시 해당 장비 상태기계 초기화
+static void abortRamenEject(uint8_t idx) {
+  ramenEjectStatus[idx] = EJECT_IDLE;
+}
+
+// 이전(중단된) 배출 사이클에서 ISR 이 남긴 리밋 정지 표시를 지운다.
+// 남아 있으면 다음 배출의 전진 / 복귀가 시작하자마자 끝난 것으로 처리된다.
+static void clearRamenEjectLimits(uint8_t idx) {
+  takeLimitStop(RAMEN_EJ_FWD_OUT[idx]);
+  takeLimitStop(RAMEN_EJ_REV_OUT[idx]);
+}
+
+// 배출 복귀 (전진 완료 후, 또는 slideinit 으로 직접)
+static void startRamenReturn(uint8_t idx) {
+  takeLimitStop(RAMEN_EJ_REV_OUT[idx]);  // 이번 복귀 이전의 표시
+  digitalWrite(RAMEN_EJ_REV_OUT[idx], HIGH);
+  superviseMotion(RAMEN_EJ_REV_OUT[idx], "ramen", idx, "return", RAMEN_EJECT_TIMEOUT_MS, abortRamenEject);
+  ramenEjectStatus[idx] = EJECT_RETURNING;
+}
+
 /**
- * @brief 
+ * @brief 면 배출 시작 (전진 -> 상한 도달 시 자동 복귀). 장비마다 독립적으로 동작
  */
 void startRamenEject(uint8_t idx) {
-  //
-  if (idx == 0) {
-    if (ramenEjectStatus == EJECT_IDLE) {
-      Serial.print("명령: 면 배출 시작 (장비: ");
-      Serial.print(idx + 1);
-      Serial.println(")");
-      ramenEjectStatus = EJECTING;
-      digitalWrite(RAMEN_EJ_FWD_OUT[idx], HIGH);
-    } else {
-      Serial.print("Warning: Eject command ignored. Status is not IDLE.");
-    }
-  } else {
-
-    digitalWrite(RAMEN_EJ_FWD_OUT[idx], HIGH);
+  if (ramenEjectStatus[idx] != EJECT_IDLE) {
+    LOG(MSG_RAMEN_EJECT_BUSY, idx + 1);
+    return;
   }
+  LOG(MSG_RAMEN_EJECT_START, idx + 1);
+  clearRamenEjectLimits(idx);
+  ramenEjectStatus[idx] = EJECTING;
+  digitalWrite(RAMEN_EJ_FWD_OUT[idx], HIGH);
+  superviseMotion(RAMEN_EJ_FWD_OUT[idx], "ramen", idx, "eject", RAMEN_EJECT_TIMEOUT_MS, abortRamenEject);
 }
 
 /**
- * @brief 
+ * @brief 장비별 배출 상태기계 진행 (전진 -> 복귀 -> 대기)
  */
 void checkRamenEject() {
-  if (current.ramen > 0) {
-    switch (ramenEjectStatus) {
+  for (uint8_t i = 0; i < current.ramen; i++) {
+    switch (ramenEjectStatus[i]) {
       case EJECTING:
-        if (digitalRead(RAMEN_EJ_TOP_IN[0]) == HIGH) {
-          Serial.println("상태: 배출 상한 도달. 복귀 시작 (장비: 1)");
-          digitalWrite(RAMEN_EJ_FWD_OUT[0], LOW);
-          digitalWrite(RAMEN_EJ_REV_OUT[0], HIGH);
-          ramenEjectStatus = EJECT_RETURNING;
+        // 리밋 ISR 이 이미 전진을 끊었거나, 상한 센서가 HIGH
+        if (takeLimitStop(RAMEN_EJ_FWD_OUT[i]) || digitalRead(RAMEN_EJ_TOP_IN[i]) == HIGH) {
+          LOG(MSG_RAMEN_EJECT_TOP, i + 1);
+          digitalWrite(RAMEN_EJ_FWD_OUT[i], LOW);
+          releaseMotion(RAMEN_EJ_FWD_OUT[i]);
+          startRamenReturn(i);
         }
         break;
       case EJECT_RETURNING:
-        if (digitalRead(RAMEN_EJ_BTM_IN[0]) == HIGH) {
-          Serial.println("완료: 상승 하한 감지. 배출 복귀 모터 정지 (장비: 1)");
-          digitalWrite(RAMEN_EJ_REV_OUT[0], LOW);
-          ramenEjectStatus = EJECT_IDLE;
+        if (takeLimitStop(RAMEN_EJ_REV_OUT[i]) || digitalRead(RAMEN_EJ_BTM_IN[i]) == HIGH) {
+          LOG(MSG_RAMEN_EJECT_DONE, i + 1);
+          digitalWrite(RAMEN_EJ_REV_OUT[i], LOW);
+          releaseMotion(RAMEN_EJ_REV_OUT[i]);
+          ramenEjectStatus[i] = EJECT_IDLE;
+          sendEvent("ramen", i + 1, "ejected");
         }
         break;
       default: break;
     }
   }
-
-  // 2. 단순 감시 (idx > 0 포함 모든 장비)
-  for (uint8_t i = 0; i < current.ramen; i++) {
-    if (digitalRead(RAMEN_EJ_FWD_OUT[i]) == HIGH && digitalRead(RAMEN_EJ_TOP_IN[i]) == HIGH) {
-      digitalWrite(RAMEN_EJ_FWD_OUT[i], LOW);
-    }
-    if (digitalRead(RAMEN_EJ_REV_OUT[i]) == HIGH && digitalRead(RAMEN_EJ_BTM_IN[i]) == HIGH) {
-      digitalWrite(RAMEN_EJ_REV_OUT[i], LOW);
-    }
-  }
 }
 
+// 스프 배출 마감 초과 시 타이머 상태 정리
+static void abortPowderDispense(uint8_t idx) {
+  isPowderDispensing[idx] = false;
+}
 
 /**
  * @brief [수정] 스프 배출을 시작 (지정된 장비, 지정된 시간)
  */
 void startPowderDispense(uint8_t idx, unsigned long durationMs) {
   if (isPowderDispensing[idx] == false) {
-    Serial.print("명령: 스프 배출 시작 (장비: ");
-    Serial.print(idx + 1);
-    Serial.print(", 시간: ");
-    Serial.print(durationMs);
-    Serial.println("ms)");
+    LOG(MSG_POWDER_DISPENSE_START, idx + 1, durationMs);
 
     isPowderDispensing[idx] = true;
     powderDuration[idx] = durationMs;
     powderStartTime[idx] = millis();
     digitalWrite(POWDER_MOTOR_OUT[idx], HIGH);
+    superviseMotion(POWDER_MOTOR_OUT[idx], "powder", idx, "dispense",
+                    durationMs + POWDER_TIMEOUT_MARGIN_MS, abortPowderDispense);
   }
 }
 
@@ -342,10 +509,9 @@ void checkPowderDispense() {
   for (uint8_t i = 0; i < current.powder; i++) {
     if (isPowderDispensing[i]) {
       if (millis() - powderStartTime[i] >= powderDuration[i]) {
-        Serial.print("완료: 시간 경과. 스프 배출 중지 (장비: ");
-        Serial.print(i + 1);
-        Serial.println(")");
+        LOG(MSG_POWDER_DISPENSE_DONE, i + 1);
         digitalWrite(POWDER_MOTOR_OUT[i], LOW);
+        releaseMotion(POWDER_MOTOR_OUT[i]);
         isPowderDispensing[i] = false;
       }
     }
@@ -356,22 +522,86 @@ void checkPowderDispense() {
  * @brief [수정] 배출구 오픈 시작 (모든 장비)
  */
 void startOutletOpen(int pinIdx) {
-  Serial.print("명령: 배출구 오픈 시작 (장비: ");
-  Serial.print(pinIdx + 1);
-  Serial.println(")");
+  LOG(MSG_OUTLET_OPEN_START, pinIdx + 1);
   digitalWrite(OUTLET_REV_OUT[pinIdx], LOW); 
+  releaseMotion(OUTLET_REV_OUT[pinIdx]);
   digitalWrite(OUTLET_FWD_OUT[pinIdx], HIGH);
+  superviseMotion(OUTLET_FWD_OUT[pinIdx], "outlet", pinIdx, "open", OUTLET_DOOR_TIMEOUT_MS);
+}
+
+// 닫힘 마감 초과: 자동 닫기였다면 레인을 비움 상태로 (fault 는 감시기가 보고)
+static void abortOutletClose(uint8_t idx) {
+  if (outletLanes[idx].phase == LANE_CLOSING) outletLanes[idx].phase = LANE_EMPTY;
 }
 
 /**
  * @brief [수정] 배출구 닫기 시작 (모든 장비)
  */
 void startOutletClose(int pinIdx) {
-  Serial.print("명령: 배출구 닫기 시작 (장비: ");
-  Serial.print(pinIdx + 1);
-  Serial.println(")");
+  LOG(MSG_OUTLET_CLOSE_START, pinIdx + 1);
   digitalWrite(OUTLET_FWD_OUT[pinIdx], LOW);
+  releaseMotion(OUTLET_FWD_OUT[pinIdx]);
   digitalWrite(OUTLET_REV_OUT[pinIdx], HIGH);
+  superviseMotion(OUTLET_REV_OUT[pinIdx], "outlet", pinIdx, "close", OUTLET_DOOR_TIMEOUT_MS, abortOutletClose);
+}
+
+// 조건이 holdMs 동안 계속 참이면 true (거짓이 되면 다시 잼)
+static bool heldFor(OutletLane& lane, bool cond, unsigned long holdMs) {
+  if (!cond) {
+    lane.holding = false;
+    return false;
+  }
+  unsigned long now = millis();
+  if (!lane.holding) {
+    lane.holding = true;
+    lane.holdStart = now;
+  }
+  return now - lane.holdStart >= holdMs;
+}
+
+/**
+ * @brief 배출구 그릇 전달: 로드셀로 놓임 / 가져감을 보고 문을 자동으로 여닫는다
+ * 놓임(OUTLET_PLACE_LOAD 이상 유지) -> 문 열기, "placed"
+ * 가져감(OUTLET_REMOVE_LOAD 미만 유지) -> 문 닫기, "pickup" (dwell: 놓임 ~ 가져감 ms)
+ * 닫힘 완료 -> "free" (다음 주문에 레인 사용 가능, checkOutlet 에서)
+ */
+static void checkOutletLane(uint8_t i) {
+  OutletLane& lane = outletLanes[i];
+  int load = state.outlet_loadcell[i];
+
+  switch (lane.phase) {
+    case LANE_EMPTY:
+      if (heldFor(lane, load >= OUTLET_PLACE_LOAD, OUTLET_PLACE_HOLD_MS)) {
+        lane.holding = false;
+        lane.placedAt = lane.holdStart;
+        lane.phase = LANE_WAITING;
+        LOG(MSG_OUTLET_PLACED, i + 1, load);
+        sendEvent("outlet", i + 1, "placed", "load", load);
+        startOutletOpen(i);
+      }
+      break;
+
+    case LANE_WAITING:
+      if (heldFor(lane, load < OUTLET_REMOVE_LOAD, OUTLET_REMOVE_HOLD_MS)) {
+        unsigned long dwell = lane.holdStart - lane.placedAt;
+        lane.holding = false;
+        lane.phase = LANE_CLOSING;
+        LOG(MSG_OUTLET_PICKUP, i + 1, dwell);
+        sendEvent("outlet", i + 1, "pickup", "dwell", dwell);
+        startOutletClose(i);
+      }
+      break;
+
+    case LANE_CLOSING:
+      // 닫는 중 다시 놓이면 (손님이 되돌려 놓음) 문을 다시 연다
+      if (heldFor(lane, load >= OUTLET_PLACE_LOAD, OUTLET_PLACE_HOLD_MS)) {
+        lane.holding = false;
+        lane.phase = LANE_WAITING;
+        LOG(MSG_OUTLET_REPLACED, i + 1);
+        startOutletOpen(i);
+      }
+      break;
+  }
 }
 
 /**
@@ -380,33 +610,141 @@ void startOutletClose(int pinIdx) {
  */
 void checkOutlet() {
   for (uint8_t i = 0; i < current.outlet; i++) {
-    if (digitalRead(OUTLET_FWD_OUT[i]) == HIGH) {
-      if (digitalRead(OUTLET_OPEN_IN[i]) == HIGH) {
-        Serial.print("완료: 배출구 오픈 완료 (장비: ");
-        Serial.print(i + 1);
-        Serial.println(")");
+    bool openStopped = takeLimitStop(OUTLET_FWD_OUT[i]);   // 리밋 ISR 이 이미 정지
+    bool closeStopped = takeLimitStop(OUTLET_REV_OUT[i]);
+
+    if (openStopped || digitalRead(OUTLET_FWD_OUT[i]) == HIGH) {
+      if (openStopped || digitalRead(OUTLET_OPEN_IN[i]) == HIGH) {
+        LOG(MSG_OUTLET_OPEN_DONE, i + 1);
         digitalWrite(OUTLET_FWD_OUT[i], LOW);
+        releaseMotion(OUTLET_FWD_OUT[i]);
       }
     }
 
-    if (digitalRead(OUTLET_REV_OUT[i]) == HIGH) {
-      if (digitalRead(OUTLET_CLOSE_IN[i]) == HIGH) {
-        Serial.print("완료: 배출구 닫힘 완료 (장비: ");
-        Serial.print(i + 1);
-        Serial.println(")");
+    if (closeStopped || digitalRead(OUTLET_REV_OUT[i]) == HIGH) {
+      if (closeStopped || digitalRead(OUTLET_CLOSE_IN[i]) == HIGH) {
+        LOG(MSG_OUTLET_CLOSE_DONE, i + 1);
         digitalWrite(OUTLET_REV_OUT[i], LOW);
+        releaseMotion(OUTLET_REV_OUT[i]);
+        if (outletLanes[i].phase == LANE_CLOSING) {
+          outletLanes[i].phase = LANE_EMPTY;
+          sendEvent("outlet", i + 1, "free");
+        }
       }
     }
+
+    if (OUTLET_AUTO_HANDOFF) checkOutletLane(i);
+  }
+}
+
+// 급수 / 가열 출력 모두 끄고 대기 상태로
+static void stopCookOutputs(uint8_t idx) {
+  digitalWrite(COOKER_WTR_SIG[idx], LOW);
+  digitalWrite(COOKER_IND_SIG[idx], LOW);
+  releaseMotion(COOKER_WTR_SIG[idx]);
+  releaseMotion(COOKER_IND_SIG[idx]);
+  cookers[idx].phase = COOK_IDLE;
+  state.cooker_work[idx] = COOK_IDLE;
+}
+
+// 조리 마감 초과 시 (supervisor 가 해당 출력은 이미 끔) 나머지 출력도 정리
+static void abortCook(uint8_t idx) {
+  stopCookOutputs(idx);
+}
+
+// 가열 단계 진입 (heatMs 0 이면 stopcook 까지 계속, 마감 감시 없음)
+static void startCookHeat(uint8_t idx) {
+  CookProgram& c = cookers[idx];
+  c.phase = COOK_HEATING;
+  c.phaseStart = millis();
+  state.cooker_work[idx] = COOK_HEATING;
+  digitalWrite(COOKER_IND_SIG[idx], HIGH);
+  if (c.heatMs) {
+    superviseMotion(COOKER_IND_SIG[idx], "cooker", idx, "heat",
+                    c.heatMs + COOKER_TIMEOUT_MARGIN_MS, abortCook);
+  }
+}
+
+/**
+ * @brief 조리 프로그램 시작: water(ml) 만큼 급수 -> timer(초) 동안 가열 -> 자동 정지
+ * 장비마다 독립적으로 동시에 진행된다.
+ */
+void startCook(uint8_t idx, unsigned long waterMl, unsigned long timerUnits) {
+  CookProgram& c = cookers[idx];
+  c.fillMs = waterMl * 1000UL / COOKER_WATER_ML_PER_SEC;
+  c.heatMs = timerUnits * COOKER_TIMER_UNIT_MS;
+  LOG(MSG_COOK_START, idx + 1, waterMl, timerUnits);
+
+  if (c.fillMs == 0) {
+    startCookHeat(idx);
+    return;
+  }
+  c.phase = COOK_FILLING;
+  c.phaseStart = millis();
+  state.cooker_work[idx] = COOK_FILLING;
+  digitalWrite(COOKER_WTR_SIG[idx], HIGH);
+  superviseMotion(COOKER_WTR_SIG[idx], "cooker", idx, "water",
+                  c.fillMs + COOKER_TIMEOUT_MARGIN_MS, abortCook);
+}
+
+void stopCook(uint8_t idx) {
+  stopCookOutputs(idx);
+}
+
+/**
+ * @brief 모든 조리 프로그램의 단계 전환 확인 (loop에서 계속 호출)
+ */
+void checkCooker() {
+  unsigned long now = millis();
+
+  for (uint8_t i = 0; i < current.cooker; i++) {
+    CookProgram& c = cookers[i];
+
+    if (c.phase == COOK_FILLING && now - c.phaseStart >= c.fillMs) {
+      digitalWrite(COOKER_WTR_SIG[i], LOW);
+      releaseMotion(COOKER_WTR_SIG[i]);
+      LOG(MSG_COOK_FILL_DONE, i + 1);
+      startCookHeat(i);
+    } else if (c.phase == COOK_HEATING && c.heatMs && now - c.phaseStart >= c.heatMs) {
+      stopCookOutputs(i);
+      LOG(MSG_COOK_DONE, i + 1);
+      sendEvent("cooker", i + 1, "done");
+    }
   }
 }
 
+// 프로그램 전체 남은 시간 (ms). 대기 중이거나 가열 시간이 정해지지 않았으면 0
+unsigned long cookRemainingMs(uint8_t idx) {
+  const CookProgram& c = cookers[idx];
+  unsigned long elapsed = millis() - c.phaseStart;
+
+  if (c.phase == COOK_FILLING) {
+    return (elapsed < c.fillMs ? c.fillMs - elapsed : 0) + c.heatMs;
+  }
+  if (c.phase == COOK_HEATING && c.heatMs) {
+    return elapsed < c.heatMs ? c.heatMs - elapsed : 0;
+  }
+  return 0;
+}
+
+// 프로그램 진행률 (0~100). 가열 시간이 정해지지 않은 가열 단계는 급수 완료 기준
+int cookProgress(uint8_t idx) {
+  const CookProgram& c = cookers[idx];
+  if (c.phase == COOK_IDLE) return 0;
+
+  if (c.phase == COOK_HEATING && !c.heatMs) return 100;
+
+  unsigned long total = c.fillMs + c.heatMs;
+  return (int)((total - cookRemainingMs(idx)) * 100ULL / total);
+}
+
 // =======================================================
 // === 3. JSON 명령 핸들러 (API 2.x)
 // =======================================================
 
-bool handleCupCommand(const JsonDocument& doc) {
-  int control = doc["control"] | 0;
-  const char* func = doc["function"] | "";
+bool handleCupCommand(const Command& cmd) {
+  int control = cmd.control;
+  const char* func = cmd.function;
   if (control <= 0 || control > current.cup) {
     sendError("cup", control, "invalid cup control num");
     return false;
@@ -415,54 +753,65 @@ bool handleCupCommand(const JsonDocument& doc) {
   uint8_t idx = control - 1;
 
   if (strcmp(func, "startdispense") == 0) {
-    startCupDispense(idx);
-    Serial.println("cup startdispense");
+    // count 개를 큐에 추가 (없으면 1개)
+    queueCupDispense(idx, cmd.count > 0 ? cmd.count : 1);
+    LOG(MSG_CMD_CUP_START);
   } else if (strcmp(func, "stopdispense") == 0) {
-    digitalWrite(CUP_MOTOR_OUT[idx], LOW);
-    Serial.println("cup stopdispense");
+    cancelCupQueue(idx);  // 이 채널 큐와 이 채널이 쓰던 유닛
+    stopCupUnit(idx);     // 같은 번호 유닛 (다른 채널이 쓰던 중이면 그 1개 실패)
+    LOG(MSG_CMD_CUP_STOP);
   } else {
-    Serial.println("unknown cup function");
+    LOG(MSG_CMD_CUP_UNKNOWN);
   }
   return true;
 }
 
-bool handleRamenCommand(const JsonDocument& doc) {
-  int control = doc["control"] | 0;
-  const char* func = doc["function"] | "";
+bool handleRamenCommand(const Command& cmd) {
+  int control = cmd.control;
+  const char* func = cmd.function;
   if (control <= 0 || control > current.ramen) {
     sendError("ramen", control, "invalid ramen control num");
     return false;
   }
   uint8_t idx = control - 1;
-  Serial.println("start handle ramen");
+  LOG(MSG_CMD_RAMEN_HANDLE);
 
   if (strcmp(func, "startdispense") == 0) {
     startRamenEject(idx);
-    Serial.println("ramen startdispense");
+    LOG(MSG_CMD_RAMEN_START);
   } else if (strcmp(func, "readydispense") == 0) {
     startRamenRise(idx);
-    Serial.println("ramen readydispense");
+    LOG(MSG_CMD_RAMEN_READY);
   } else if (strcmp(func, "initdispense") == 0) {
     startRamenInit(idx);
-    Serial.println("ramen initdispense");
+    LOG(MSG_CMD_RAMEN_INIT);
   } else if (strcmp(func, "stopdispense") == 0) {
     digitalWrite(RAMEN_EJ_FWD_OUT[idx], LOW);
     digitalWrite(RAMEN_EJ_REV_OUT[idx], LOW);
     digitalWrite(RAMEN_UP_FWD_OUT[idx], LOW);
     digitalWrite(RAMEN_UP_REV_OUT[idx], LOW);
-    if (idx == 0) { ramenEjectStatus = EJECT_IDLE; }
-    Serial.println("ramen stopdispense (ALL STOP)");
-  } else if (strcmp(func, "slideinit")){
-    digitalWrite(RAMEN_EJ_REV_OUT[idx], HIGH);
+    releaseMotion(RAMEN_EJ_FWD_OUT[idx]);
+    releaseMotion(RAMEN_EJ_REV_OUT[idx]);
+    releaseMotion(RAMEN_UP_FWD_OUT[idx]);
+    releaseMotion(RAMEN_UP_REV_OUT[idx]);
+    clearRamenEjectLimits(idx);
+    ramenEjectStatus[idx] = EJECT_IDLE;
+    LOG(MSG_CMD_RAMEN_STOP);
+  } else if (strcmp(func, "slideinit") == 0) {
+    if (ramenEjectStatus[idx] == EJECTING) {
+      digitalWrite(RAMEN_EJ_FWD_OUT[idx], LOW);
+      releaseMotion(RAMEN_EJ_FWD_OUT[idx]);
+    }
+    if (ramenEjectStatus[idx] != EJECT_RETURNING) startRamenReturn(idx);
   } else {
     sendError("ramen", control, "unknown ramen function");
   }
   return true;
 }
 
-bool handlePowderCommand(const JsonDocument& doc) {
-  int control = doc["control"] | 0;
-  const char* func = doc["function"] | "";
+bool handlePowderCommand(const Command& cmd) {
+  int control = cmd.control;
+  const char* func = cmd.function;
   if (control <= 0 || control > current.powder) {
     sendError("powder", control, "invalid powder control num");
     return false;
@@ -471,7 +820,7 @@ bool handlePowderCommand(const JsonDocument& doc) {
 
   if (strcmp(func, "startdispense") == 0) {
 
-    int time_val = doc["time"] | 0;
+    int time_val = cmd.time;
 
     if (time_val <= 0) {
       sendError("powder", control, "Error: 'time' 0 or missing");
@@ -480,26 +829,49 @@ bool handlePowderCommand(const JsonDocument& doc) {
 
     unsigned long durationMs = (unsigned long)time_val * 100;
 
-    Serial.print("powder startdispense (장비: ");
-    Serial.print(idx + 1);
-    Serial.print(", 시간: ");
-    Serial.print(durationMs);
-    Serial.println(" ms)");
+    LOG(MSG_CMD_POWDER_START, idx + 1, durationMs);
 
-    startPowderDispense(idx, durationMs);
+    if (powderDoseActive(idx)) {
+      sendError("powder", control, "powder busy");
+    } else {
+      startPowderDispense(idx, durationMs);
+    }
+  } else if (strcmp(func, "dose") == 0) {
+    // 목표량(mg) 정량 배출: 유량 모델 + 부하 전류 보정 (dosing.h)
+    if (cmd.dose <= 0) {
+      sendError("powder", control, "Error: 'dose' 0 or missing");
+      return false;
+    }
+    if (isPowderDispensing[idx] || !startPowderDose(idx, cmd.dose)) {
+      sendError("powder", control, "powder busy");
+    }
+  } else if (strcmp(func, "calibrate") == 0) {
+    // 직전 정량 배출의 실제 무게(mg) 로 모델 학습
+    if (cmd.dose <= 0) {
+      sendError("powder", control, "Error: 'dose' 0 or missing");
+      return false;
+    }
+    CalibrateResult r = calibratePowderDose(idx, cmd.dose);
+    if (r == CALIBRATE_NO_DOSE) {
+      sendError("powder", control, "no dose to calibrate");
+    } else if (r == CALIBRATE_NOT_SAVED) {
+      sendError("powder", control, "calibration not saved");
+    }
   } else if (strcmp(func, "stopdispense") == 0) {
     digitalWrite(POWDER_MOTOR_OUT[idx], LOW);
+    releaseMotion(POWDER_MOTOR_OUT[idx]);
     isPowderDispensing[idx] = false;
-    Serial.println("powder stopdispense");
+    stopPowderDose(idx);
+    LOG(MSG_CMD_POWDER_STOP);
   } else {
     sendError("powder", control, "unknown powder function");
   }
   return true;
 }
 
-bool handleCookerCommand(const JsonDocument& doc) {
-  int control = doc["control"] | 0;
-  const char* func = doc["function"] | "";
+bool handleCookerCommand(const Command& cmd) {
+  int control = cmd.control;
+  const char* func = cmd.function;
   if (control <= 0 || control > current.cooker) {
     sendError("cooker", control, "invalid cooker control num");
     return false;
@@ -507,20 +879,20 @@ bool handleCookerCommand(const JsonDocument& doc) {
   uint8_t idx = control - 1;
 
   if (strcmp(func, "startcook") == 0) {
-    int water = doc["water"];
-    int timer = doc["timer"];
-    if (idx < 2) {
-      digitalWrite(COOKER_WTR_SIG[idx], HIGH);
-      digitalWrite(COOKER_IND_SIG[idx], HIGH);
+    int water = cmd.water;
+    int timer = cmd.timer;
+    LOG(MSG_CMD_COOKER_START);
+    if (water < 0 || timer < 0) {
+      sendError("cooker", control, "invalid water/timer");
+    } else if (cookers[idx].phase != COOK_IDLE) {
+      sendError("cooker", control, "cooker busy");
+    } else {
+      startCook(idx, water, timer);
     }
-    Serial.println("cooker startcook");
 
   } else if (strcmp(func, "stopcook") == 0) {
-    if (idx < 2) {
-      digitalWrite(COOKER_WTR_SIG[idx], LOW);
-      digitalWrite(COOKER_IND_SIG[idx], LOW);
-    }
-    Serial.println("cooker stopcook");
+    stopCook(idx);
+    LOG(MSG_CMD_COOKER_STOP);
 
   } else {
     sendError("cooker", control, "unknown cooker function");
@@ -528,23 +900,30 @@ bool handleCookerCommand(const JsonDocument& doc) {
   return true;
 }
 
-bool handleOutletCommand(const JsonDocument& doc) {
-  int control = doc["control"] | 0;
-  const char* func = doc["function"] | "";
+bool handleOutletCommand(const Command& cmd) {
+  int control = cmd.control;
+  const char* func = cmd.function;
+  if (control <= 0 || control > current.outlet) {
+    sendError("outlet", control, "invalid outlet control num");
+    return false;
+  }
   uint8_t idx = control - 1;
 
   if (strcmp(func, "opendoor") == 0) {
     startOutletOpen(idx);
-    Serial.println("outlet opendoor");
+    LOG(MSG_CMD_OUTLET_OPEN);
 
   } else if (strcmp(func, "closedoor") == 0) {
     startOutletClose(idx);
-    Serial.println("outlet closedoor");
+    LOG(MSG_CMD_OUTLET_CLOSE);
 
   } else if (strcmp(func, "stopoutlet") == 0) {
     digitalWrite(OUTLET_FWD_OUT[idx], LOW);
     digitalWrite(OUTLET_REV_OUT[idx], LOW);
-    Serial.println("outlet stopoutlet");
+    releaseMotion(OUTLET_FWD_OUT[idx]);
+    releaseMotion(OUTLET_REV_OUT[idx]);
+    if (outletLanes[idx].phase == LANE_CLOSING) outletLanes[idx].phase = LANE_EMPTY;
+    LOG(MSG_CMD_OUTLET_STOP);
 
   } else {
     sendError("outlet", control, "unknown outlet function");
@@ -556,54 +935,111 @@ bool handleOutletCommand(const JsonDocument& doc) {
 // === 4. 메인 파서 (Main Parser)
 // =======================================================
 
-bool handleSettingJson(const JsonDocument& doc) {
-  Setting next;
-  next.cup = doc["cup"] | 0;
-  next.ramen = doc["ramen"] | 0;
-  next.powder = doc["powder"] | 0;
-  next.cooker = doc["cooker"] | 0;
-  next.outlet = doc["outlet"] | 0;
+bool handleSettingJson(const Command& cmd) {
+  Setting next = cmd.setting;
 
-  String reason = "";
+  const char* reason = "";
   if (!validateRules(next, reason)) {
-    // 설정 유효성 실패
-    sendError("setting", 0, reason.c_str());
+    // 설정 유효성 실패: 적용하지 않는다 (핀표 밖 번호로 ISR 이 붙지 않게)
+    sendError("setting", 0, reason);
+    return false;
   }
 
   applySetting(next);
-  Serial.println("pins configured");
+  LOG(MSG_PINS_CONFIGURED);
+#ifdef TELEMETRY_BENCH
+  benchTelemetry();
+#endif
   return true;
 }
 
 void checkSensor() { /* ... */
 }
 
-bool parseAndDispatch(const char* json) {
-  StaticJsonDocument<512> doc;
-
-  DeserializationError err = deserializeJson(doc, json);
-  if (err) {
-    sendError("system", 0, "json parse fail");
-  }
-
-  const char* dev = doc["device"] | "";
+static bool dispatchCommand(const Command& cmd) {
+  const char* dev = cmd.device;
 
   if (strcmp(dev, "setting") == 0) {
-    return handleSettingJson(doc);
+    return handleSettingJson(cmd);
   } else if (strcmp(dev, "query") == 0) {
     replyCurrentSetting(current);
+    sendSchedulerStats();
+    sendMemStats();
+    return true;
+  } else if (strcmp(dev, "ping") == 0) {
+    sendPong(cmd.seq);
     return true;
   } else if (strcmp(dev, "cup") == 0) {
-    return handleCupCommand(doc);
+    return handleCupCommand(cmd);
   } else if (strcmp(dev, "ramen") == 0) {
-    return handleRamenCommand(doc);
+    return handleRamenCommand(cmd);
   } else if (strcmp(dev, "powder") == 0) {
-    return handlePowderCommand(doc);
+    return handlePowderCommand(cmd);
   } else if (strcmp(dev, "cooker") == 0) {
-    return handleCookerCommand(doc);
+    return handleCookerCommand(cmd);
   } else if (strcmp(dev, "outlet") == 0) {
-    return handleOutletCommand(doc);
+    return handleOutletCommand(cmd);
   } else {
     sendError("system", 0, "unsupported device field");
+    return false;
+  }
+}
+
+#if JSON_FALLBACK
+// 토크나이저 스키마 밖의 명령만 ArduinoJson 으로 재파싱
+// (DOM 은 이 경로에서만 스택에 잡히도록 별도 함수로 분리)
+static bool __attribute__((noinline)) dispatchJsonFallback(const char* json) {
+  StaticJsonDocument<512> doc;
+
+  DeserializationError err = deserializeJson(doc, json);
+  if (err) {
+    sendError("system", 0, "json parse fail");
+    return false;
+  }
+
+  // 숫자 값은 토크나이저와 같은 범위로 검사 (uint8_t / uint16_t 로 잘려 들어가지 않게)
+  for (JsonPairConst kv : doc.as<JsonObjectConst>()) {
+    if (kv.value().is<long>() && !commandNumberInRange(kv.key().c_str(), kv.value().as<long>())) {
+      sendError("system", 0, "value out of range");
+      return false;
+    }
+  }
+
+  Command cmd;
+  cmd.device = doc["device"] | "";
+  cmd.function = doc["function"] | "";
+  cmd.control = doc["control"] | 0;
+  cmd.time = doc["time"] | 0;
+  cmd.water = doc["water"] | 0;
+  cmd.timer = doc["timer"] | 0;
+  cmd.seq = doc["seq"] | 0;
+  cmd.dose = doc["dose"] | 0;
+  cmd.count = doc["count"] | 0;
+  cmd.setting.cup = doc["cup"] | 0;
+  cmd.setting.ramen = doc["ramen"] | 0;
+  cmd.setting.powder = doc["powder"] | 0;
+  cmd.setting.cooker = doc["cooker"] | 0;
+  cmd.setting.outlet = doc["outlet"] | 0;
+  return dispatchCommand(cmd);
+}
+#endif
+
+bool parseAndDispatch(char* json) {
+  Command cmd;
+
+  switch (tokenizeCommand(json, cmd)) {
+    case CMD_OK:
+      return dispatchCommand(cmd);
+#if JSON_FALLBACK
+    case CMD_UNKNOWN_SHAPE:
+      return dispatchJsonFallback(json);
+#endif
+    case CMD_RANGE_ERROR:
+      sendError("system", 0, "value out of range");
+      return false;
+    default:
+      // 파싱 실패 시 빈 명령으로 dispatch 하지 않고 중단
+      sendError("system", 0, "json parse fail");
+      return false;
   }
 }
@@ -2,20 +2,19 @@
 #define PROTOCOL_H
 
 #include <Arduino.h>
-#include <ArduinoJson.h>
 #include "state.h" // 'Setting' 구조체를 사용하기 위해 포함
 
 // =======================================================
 // === 1. 메인 파서 및 설정 함수
 // =======================================================
 
-// 메인 JSON 파서
-bool parseAndDispatch(const char* json);
+// 메인 JSON 파서 (json 은 RX 버퍼, 제자리에서 토큰화됨)
+bool parseAndDispatch(char* json);
 
 // 설정 적용 함수 (Setting 시 호출)
 void applySetting(const Setting& s);
 void replyCurrentSetting(const Setting& s);
-bool validateRules(const Setting& s, String& why);
+bool validateRules(const Setting& s, const char*& why);
 
 // 핀모드 설정 함수 (applySetting 내부에서 호출)
 void setupCup(uint8_t n);
@@ -29,13 +28,15 @@ void setupCooker(uint8_t n);
 // === 2. 비동기 "시작" 함수 (JSON 핸들러가 호출)
 // =======================================================
 
-// --- Cup (1번 장비 전용) ---
-void startCupDispense();
+// --- Cup (채널별 배출 큐) ---
+void queueCupDispense(uint8_t ch, uint16_t count);
+void cancelCupQueue(uint8_t ch);
+void resetCupQueues();
 
-// --- Ramen (1번 장비 전용) ---
-void startRamenRise();
-void startRamenInit();
-void startRamenEject();
+// --- Ramen ---
+void startRamenRise(uint8_t idx);
+void startRamenInit(uint8_t idx);
+void startRamenEject(uint8_t idx);
 
 // --- Powder (1번 장비 전용) ---
 void startPowderDispense();
@@ -44,15 +45,20 @@ void startPowderDispense();
 void startOutletOpen(int pinIdx);
 void startOutletClose(int pinIdx);
 
+// --- Cooker (모든 장비, 동시 진행) ---
+void startCook(uint8_t idx, unsigned long waterMl, unsigned long timerUnits);
+void stopCook(uint8_t idx);
+
 
 // =======================================================
 // === 3. 비동기 "감시" 함수 (Main.ino의 loop()가 호출)
 // =======================================================
 
-// --- Cup (1번 장비 전용) ---
+// --- Cup (모든 장비) ---
 void checkCupDispense();
+int cupQueueLength(uint8_t ch);  // 텔레메트리용
 
-// --- Ramen (1번 장비 전용) ---
+// --- Ramen ---
 void checkRamenRise();
 void checkRamenInit();
 void checkRamenEject();
@@ -63,4 +69,9 @@ void checkPowderDispense();
 // --- Outlet (모든 장비) ---
 void checkOutlet(); // (내부에서 모든 Outlet을 검사)
 
+// --- Cooker (모든 장비) ---
+void checkCooker();
+unsigned long cookRemainingMs(uint8_t idx);  // 텔레메트리용
+int cookProgress(uint8_t idx);
+
 #endif // PROTOCOL_H
\ No newline at end of file
@@ -1,8 +1,17 @@
 #include <Arduino.h>
-#include <ArduinoJson.h>
 #include "reporting.h"
 #include "config.h" 
+#ifdef TELEMETRY_BENCH
+#include <ArduinoJson.h>
+#endif
 #include "state.h"
+#include "protocol.h"  // 조리 진행률
+#include "dosing.h"    // 스프 정량 배출량
+#include "frame.h"
+#include "log.h"
+#include "devclock.h"
+#include "transport.h"
+#include "sensestat.h"   // 보고 구간 통계
 unsigned long ramenPhotoDebounceTime[MAX_RAMEN] = {0};
 int ramenPhotoPrevState[MAX_RAMEN] = {0};            
 const unsigned long DEBOUNCE_DELAY_MS = 50;          
@@ -91,115 +100,418 @@ void readAllSensors() {
     state.powder_dispense[i] = (digitalRead(POWDER_MOTOR_OUT[i]) == HIGH) ? 1 : 0; 
   }
 
-  for (i = 0; i < current.cooker; i++) {
-    state.cooker_amp[i] = filterAmpValue(COOKER_CURR_AIN[i], state.cooker_amp[i]);
-    // state.cooker_work[i] = ...
-  }
+  // 조리기 전류는 구간 통계("cur")로만 보고, cooker_work 는 조리 엔진(checkCooker)이 갱신
 
   for (i = 0; i < current.outlet; i++) {
     state.outlet_amp[i] = analogRead(OUTLET_CURR_AIN[i]);
-    if (outletScale[i].is_ready()) {
-      Serial.println('loadcell is ready');
-         state.outlet_loadcell[i] = (int)outletScale[i].get_units(5);
-    } 
+    // 로드셀(outlet_loadcell, 레인 판단용) 은 샘플 작업(sampleSensors)이 변환 완료 때마다 갱신
   }
 
   state.door_sensor1 = digitalRead(DOOR_SENSOR1_PIN);
   state.door_sensor2 = digitalRead(DOOR_SENSOR2_PIN);
 }
 
+// 객체를 닫는다. 프레임의 첫 객체에만 기기 시각(ts)을 붙이고 이후는 생략
+// (한 프레임의 객체들은 같은 시각에 만든 것)
+static void closeObject(FrameWriter& w, uint64_t& ts) {
+  if (ts) {
+    w.lit(",\"ts\":");
+    w.uinteger64(ts);
+    ts = 0;
+  }
+  w.raw('}');
+}
+
+static void writeDoorObject(FrameWriter& w, uint64_t& ts) {
+  w.lit("{\"device\":\"door\",\"sensor1\":");
+  w.integer(state.door_sensor1);
+  w.lit(",\"sensor2\":");
+  w.integer(state.door_sensor2);
+  writeEdgeWindow(w, "sensor1edge", senseWindow.door_sensor1);
+  writeEdgeWindow(w, "sensor2edge", senseWindow.door_sensor2);
+  closeObject(w, ts);
+}
+
 // 에러 전송
 void sendError(const char* device, int control, const char* errorMsg) {
-  StaticJsonDocument<256> doc;
-  
-  doc["device"] = device;
-  doc["control"] = control;
-  doc["error"] = errorMsg;
+  char buf[160];
+  FrameWriter w(buf, sizeof(buf));
+
+  w.lit("[{\"device\":");
+  w.str(device);
+  w.lit(",\"control\":");
+  w.integer(control);
+  w.lit(",\"error\":");
+  w.str(errorMsg);
+  w.lit(",\"ts\":");
+  w.uinteger64(deviceMicros());
+  w.lit("}]\r\n");
+  w.flushTo(Link);
+}
 
-  Serial.print('['); 
-  serializeJson(doc, Serial);
-  Serial.println(']');
+// 동작 마감 초과 전송
+void sendFault(const char* device, int control, const char* motion, unsigned long elapsedMs) {
+  char buf[160];
+  FrameWriter w(buf, sizeof(buf));
+
+  w.lit("[{\"device\":");
+  w.str(device);
+  w.lit(",\"control\":");
+  w.integer(control);
+  w.lit(",\"fault\":\"timeout\",\"motion\":");
+  w.str(motion);
+  w.lit(",\"ms\":");
+  w.uinteger(elapsedMs);
+  w.lit(",\"ts\":");
+  w.uinteger64(deviceMicros());
+  w.lit("}]\r\n");
+  w.flushTo(Link);
 }
 
-void publishStateJson() {
-  StaticJsonDocument<512> doc;
+// 장비 이벤트 전송
+void sendEvent(const char* device, int control, const char* event, const char* key, long value) {
+  char buf[160];
+  FrameWriter w(buf, sizeof(buf));
+
+  w.lit("[{\"device\":");
+  w.str(device);
+  w.lit(",\"control\":");
+  w.integer(control);
+  w.lit(",\"event\":");
+  w.str(event);
+  if (key) {
+    w.raw(',');
+    w.str(key);
+    w.raw(':');
+    w.integer(value);
+  }
+  w.lit(",\"ts\":");
+  w.uinteger64(deviceMicros());
+  w.lit("}]\r\n");
+  w.flushTo(Link);
+}
+
+// 부팅 알림
+void sendBoot() {
+  char buf[64];
+  FrameWriter w(buf, sizeof(buf));
+
+  w.lit("[{\"boot\":\"ready\",\"ts\":");
+  w.uinteger64(deviceMicros());
+  w.lit("}]\r\n");
+  w.flushTo(Link);
+}
+
+// 시각 동기 응답: 호스트가 보낸 seq 와 수신 시점의 기기 시각
+void sendPong(long seq) {
+  char buf[80];
+  FrameWriter w(buf, sizeof(buf));
+
+  w.lit("[{\"device\":\"pong\",\"seq\":");
+  w.integer(seq);
+  w.lit(",\"ts\":");
+  w.uinteger64(deviceMicros());
+  w.lit("}]\r\n");
+  w.flushTo(Link);
+}
+
+// ===== 송신 프레임 버퍼 =====
+static char txFrame[TELEMETRY_FRAME_SIZE];
+
+// 장비별 상태 객체들을 콤마로 이어 기록 (배열 괄호 제외), 첫 객체에 ts
+static void writeStateObjects(FrameWriter& w, uint64_t ts) {
   uint8_t i;
   bool isFirst = true; // 첫 번째 요소인지 확인하여 콤마(,) 처리를 하기 위한 플래그
 
-  Serial.print('['); 
-
   // 1. Cup
   for (i = 0; i < current.cup; i++) {
-    if (!isFirst) Serial.print(',');
+    if (!isFirst) w.raw(',');
+    isFirst = false;
+
+    w.lit("{\"device\":\"cup\",\"control\":");
+    w.integer(i + 1);
+    w.lit(",\"amp\":");
+    w.integer(checkMotorRunning(i));
+    w.lit(",\"stock\":");
+    w.integer(state.cup_stock[i]);
+    w.lit(",\"dispense\":");
+    w.integer(state.cup_dispense[i]);
+    w.lit(",\"queue\":");
+    w.integer(cupQueueLength(i));  // 남은 배출 개수
+    writeAnalogWindow(w, "cur", senseWindow.cup_amp[i]);
+    writeEdgeWindow(w, "stockedge", senseWindow.cup_stock[i]);
+    writeEdgeWindow(w, "dispenseedge", senseWindow.cup_dispense[i]);
+    closeObject(w, ts);
+  }
+
+  // 2. Ramen
+  for (i = 0; i < current.ramen; i++) {
+    if (!isFirst) w.raw(',');
+    isFirst = false;
+
+    // 복귀 중(EJECT_RETURNING)일 경우 강제 1 유지
+    // (BTM_IN이 1이 되기 전까지 슬라이딩 중으로 간주)
+    int slideInStatus = (ramenEjectStatus[i] == EJECT_RETURNING) ? 1 : 0;
+
+    w.lit("{\"device\":\"ramen\",\"control\":");
+    w.integer(i + 1);
+    w.lit(",\"liftup\":");
+    w.integer(digitalRead(RAMEN_UP_TOP_IN[i]));
+    w.lit(",\"liftdown\":");
+    w.integer(digitalRead(RAMEN_UP_BTM_IN[i]));
+    w.lit(",\"slidein\":");
+    w.integer(digitalRead(RAMEN_EJ_BTM_IN[i])); // 면 배출 상한센서
+    w.lit(",\"slideout\":");
+    w.integer(slideInStatus);
+    w.lit(",\"detect\":");
+    w.integer(state.ramen_stock[i]);
+    w.lit(",\"lift\":");
+    w.integer(state.ramen_lift[i]);
+    writeAnalogWindow(w, "cur", senseWindow.ramen_amp[i]);
+    writeEdgeWindow(w, "detectedge", senseWindow.ramen_detect[i]);
+    closeObject(w, ts);
+  }
+
+  // 3. Powder
+  for (i = 0; i < current.powder; i++) {
+    if (!isFirst) w.raw(',');
     isFirst = false;
 
+    w.lit("{\"device\":\"powder\",\"control\":");
+    w.integer(i + 1);
+    w.lit(",\"amp\":");
+    w.integer(checkMotorRunning(i));
+    w.lit(",\"dispense\":");
+    w.integer(state.powder_dispense[i]);
+    w.lit(",\"dosed\":");
+    w.uinteger(powderDosedMg(i));  // 정량 배출 추정량 (mg)
+    writeAnalogWindow(w, "cur", senseWindow.powder_amp[i]);
+    closeObject(w, ts);
+  }
+
+  // 4. Cooker
+  for (i = 0; i < current.cooker; i++) {
+    if (!isFirst) w.raw(',');
+    isFirst = false;
+
+    w.lit("{\"device\":\"cooker\",\"control\":");
+    w.integer(i + 1);
+    w.lit(",\"work\":");
+    w.integer(state.cooker_work[i]);  // 0 대기, 1 급수, 2 가열
+    w.lit(",\"progress\":");
+    w.integer(cookProgress(i));
+    w.lit(",\"remain\":");
+    w.uinteger(cookRemainingMs(i));
+    writeAnalogWindow(w, "cur", senseWindow.cooker_amp[i]);
+    closeObject(w, ts);
+  }
+
+  // 5. Outlet
+  for (i = 0; i < current.outlet; i++) {
+    if (!isFirst) w.raw(',');
+    isFirst = false;
+
+    w.lit("{\"device\":\"outlet\",\"control\":");
+    w.integer(i + 1);
+    w.lit(",\"amp\":");
+    w.integer(checkMotorRunning(i));
+    w.lit(",\"opendoor\":");
+    w.integer(digitalRead(OUTLET_OPEN_IN[i]));
+    w.lit(",\"closedoor\":");
+    w.integer(digitalRead(OUTLET_CLOSE_IN[i]));
+    w.lit(",\"sonar\":");
+    w.integer(state.outlet_sonar[i]);
+    w.lit(",\"lane\":");
+    w.integer(outletLanes[i].phase);  // 0 비어 있음, 1 손님 대기, 2 닫는 중
+    writeAnalogWindow(w, "cur", senseWindow.outlet_amp[i]);
+    writeCountedWindow(w, "load", senseWindow.outlet_load[i]);  // 로드셀 (구간 값, 샘플 수 포함)
+    closeObject(w, ts);
+  }
+
+  // 6. Door (조건부 전송: Cup 또는 Cooker가 1개 이상일 때만) [수정됨]
+  if (current.cup > 0 || current.cooker > 0) {
+    if (!isFirst) w.raw(','); // 앞선 데이터가 있다면 콤마 추가
+    writeDoorObject(w, ts);
+  }
+}
+
+void publishStateJson() {
+  FrameWriter w(txFrame, sizeof(txFrame));
+
+  w.raw('[');
+  writeStateObjects(w, deviceMicros());
+  w.lit("]\r\n"); // 통합된 JSON 배열 종료
+  nextSenseWindow();  // 보낸 구간 통계는 비우고 다음 구간 시작
+
+  if (w.overflowed()) {
+    sendError("system", 0, "telemetry frame overflow");
+    return;
+  }
+  w.flushTo(Link);
+}
+
+// setting 전, 도어 센서만 단독 전송
+void publishDoorJson() {
+  FrameWriter w(txFrame, sizeof(txFrame));
+
+  uint64_t ts = deviceMicros();
+  w.raw('[');
+  writeDoorObject(w, ts);
+  w.lit("]\r\n");
+  nextSenseWindow();
+  w.flushTo(Link);
+}
+
+void checkVolt() {
+  int v = analogRead(A3);
+  
+  LOG(MSG_VOLTAGE, v);
+}
+
+int checkMotorRunning(int currentIdx) {
+  int sendingMotorState = 0;
+
+  if (current.cup > 0 && currentIdx < current.cup) {
+    sendingMotorState = digitalRead(CUP_MOTOR_OUT[currentIdx]);
+  }
+
+  else if (current.powder > 0 && currentIdx < current.powder) {
+    sendingMotorState = digitalRead(POWDER_MOTOR_OUT[currentIdx]);
+  }
+
+  else if (current.outlet > 0 && currentIdx < current.outlet) {
+    int fwd = digitalRead(OUTLET_FWD_OUT[currentIdx]);
+    int rev = digitalRead(OUTLET_REV_OUT[currentIdx]);
+
+    sendingMotorState = (fwd == 0 && rev == 0) ? 0 : (fwd == 1 ? 1 : -1);
+  }
+
+  return sendingMotorState;
+}
+
+#ifdef TELEMETRY_BENCH
+// =========================================================
+// 텔레메트리 직렬화 벤치마크 (기존 DOM 방식 vs FrameWriter)
+// =========================================================
+
+// 바이트를 버퍼에 모으기만 하는 출력 대상
+class CaptureSink : public Print {
+public:
+  CaptureSink(char* buf, size_t cap) : len(0), _buf(buf), _cap(cap) {}
+  size_t write(uint8_t c) override {
+    if (len < _cap) _buf[len] = (char)c;
+    len++;
+    return 1;
+  }
+  size_t write(const uint8_t* b, size_t n) override {
+    for (size_t k = 0; k < n; k++) write(b[k]);
+    return n;
+  }
+  size_t len;
+private:
+  char* _buf;
+  size_t _cap;
+};
+
+static void addAnalogWindowDom(JsonDocument& doc, const char* key, const AnalogWindow& a) {
+  if (analogWindowFlat(a)) return;
+  if (a.min == a.max) {
+    doc[key] = a.min;
+    return;
+  }
+  JsonArray arr = doc.createNestedArray(key);
+  arr.add(a.min);
+  arr.add(a.max);
+  arr.add(analogWindowMean(a));
+}
+
+static void addCountedWindowDom(JsonDocument& doc, const char* key, const AnalogWindow& a) {
+  if (a.count == 0) return;
+  JsonArray arr = doc.createNestedArray(key);
+  arr.add(a.min);
+  arr.add(a.max);
+  arr.add(analogWindowMean(a));
+  arr.add(a.count);
+}
+
+static void addEdgeWindowDom(JsonDocument& doc, const char* key, const EdgeWindow& e) {
+  if (e.edges) doc[key] = e.edges;
+}
+
+// 기존 publishStateJson (StaticJsonDocument 기반) 을 비교 기준으로 보존
+static void publishStateJsonDom(Print& out, uint64_t ts) {
+  StaticJsonDocument<512> doc;
+  uint8_t i;
+  bool isFirst = true;
+
+  out.print('[');
+
+  for (i = 0; i < current.cup; i++) {
+    if (!isFirst) out.print(',');
+    isFirst = false;
     doc.clear();
     doc["device"] = "cup";
     doc["control"] = i + 1;
     doc["amp"] = checkMotorRunning(i);
     doc["stock"] = state.cup_stock[i];
     doc["dispense"] = state.cup_dispense[i];
-    serializeJson(doc, Serial);
+    doc["queue"] = cupQueueLength(i);
+    addAnalogWindowDom(doc, "cur", senseWindow.cup_amp[i]);
+    addEdgeWindowDom(doc, "stockedge", senseWindow.cup_stock[i]);
+    addEdgeWindowDom(doc, "dispenseedge", senseWindow.cup_dispense[i]);
+    if (ts) { doc["ts"] = ts; ts = 0; }  // 첫 객체에만
+    serializeJson(doc, out);
   }
 
-  // 2. Ramen
   for (i = 0; i < current.ramen; i++) {
-    if (!isFirst) Serial.print(',');
+    if (!isFirst) out.print(',');
     isFirst = false;
-
-    int slideInStatus = digitalRead(RAMEN_EJ_TOP_IN[i]); // 기본값은 센서 값
-
-    // 인덱스 0 장비에 한하여, 복귀 중(EJECT_RETURNING)일 경우 강제 1 유지
-    // (BTM_IN이 1이 되기 전까지 슬라이딩 중으로 간주)
-    if (ramenEjectStatus == EJECT_RETURNING) {
-      slideInStatus = 1; 
-    } else {
-      slideInStatus = 0;
-    }
-
     doc.clear();
     doc["device"] = "ramen";
     doc["control"] = i + 1;
     doc["liftup"] = digitalRead(RAMEN_UP_TOP_IN[i]);
     doc["liftdown"] = digitalRead(RAMEN_UP_BTM_IN[i]);
-    doc["slidein"] = digitalRead(RAMEN_EJ_BTM_IN[i]); // 면 배출 상한센서
-    doc["slideout"] = slideInStatus;
+    doc["slidein"] = digitalRead(RAMEN_EJ_BTM_IN[i]);
+    doc["slideout"] = (ramenEjectStatus[i] == EJECT_RETURNING) ? 1 : 0;
     doc["detect"] = state.ramen_stock[i];
     doc["lift"] = state.ramen_lift[i];
-    serializeJson(doc, Serial);
+    addAnalogWindowDom(doc, "cur", senseWindow.ramen_amp[i]);
+    addEdgeWindowDom(doc, "detectedge", senseWindow.ramen_detect[i]);
+    if (ts) { doc["ts"] = ts; ts = 0; }  // 첫 객체에만
+    serializeJson(doc, out);
   }
 
-  // 3. Powder
   for (i = 0; i < current.powder; i++) {
-    if (!isFirst) Serial.print(',');
+    if (!isFirst) out.print(',');
     isFirst = false;
-
     doc.clear();
     doc["device"] = "powder";
     doc["control"] = i + 1;
     doc["amp"] = checkMotorRunning(i);
     doc["dispense"] = state.powder_dispense[i];
-    serializeJson(doc, Serial);
+    doc["dosed"] = powderDosedMg(i);
+    addAnalogWindowDom(doc, "cur", senseWindow.powder_amp[i]);
+    if (ts) { doc["ts"] = ts; ts = 0; }  // 첫 객체에만
+    serializeJson(doc, out);
   }
 
-  // 4. Cooker
   for (i = 0; i < current.cooker; i++) {
-    if (!isFirst) Serial.print(',');
+    if (!isFirst) out.print(',');
     isFirst = false;
-
     doc.clear();
     doc["device"] = "cooker";
     doc["control"] = i + 1;
-    doc["amp"] = state.cooker_amp[i];
     doc["work"] = state.cooker_work[i];
-    serializeJson(doc, Serial);
+    doc["progress"] = cookProgress(i);
+    doc["remain"] = cookRemainingMs(i);
+    addAnalogWindowDom(doc, "cur", senseWindow.cooker_amp[i]);
+    if (ts) { doc["ts"] = ts; ts = 0; }  // 첫 객체에만
+    serializeJson(doc, out);
   }
 
-  // 5. Outlet
   for (i = 0; i < current.outlet; i++) {
-    if (!isFirst) Serial.print(',');
+    if (!isFirst) out.print(',');
     isFirst = false;
-
     doc.clear();
     doc["device"] = "outlet";
     doc["control"] = i + 1;
@@ -207,49 +519,64 @@ void publishStateJson() {
     doc["opendoor"] = digitalRead(OUTLET_OPEN_IN[i]);
     doc["closedoor"] = digitalRead(OUTLET_CLOSE_IN[i]);
     doc["sonar"] = state.outlet_sonar[i];
-    doc["loadcell"] = state.outlet_loadcell[i];
-    serializeJson(doc, Serial);
+    doc["lane"] = (int)outletLanes[i].phase;
+    addAnalogWindowDom(doc, "cur", senseWindow.outlet_amp[i]);
+    addCountedWindowDom(doc, "load", senseWindow.outlet_load[i]);
+    if (ts) { doc["ts"] = ts; ts = 0; }  // 첫 객체에만
+    serializeJson(doc, out);
   }
 
-  // 6. Door (조건부 전송: Cup 또는 Cooker가 1개 이상일 때만) [수정됨]
   if (current.cup > 0 || current.cooker > 0) {
-    if (!isFirst) Serial.print(','); // 앞선 데이터가 있다면 콤마 추가
-    
+    if (!isFirst) out.print(',');
     doc.clear();
     doc["device"] = "door";
     doc["sensor1"] = state.door_sensor1;
     doc["sensor2"] = state.door_sensor2;
-    serializeJson(doc, Serial);
+    addEdgeWindowDom(doc, "sensor1edge", senseWindow.door_sensor1);
+    addEdgeWindowDom(doc, "sensor2edge", senseWindow.door_sensor2);
+    if (ts) { doc["ts"] = ts; ts = 0; }  // 첫 객체에만
+    serializeJson(doc, out);
   }
 
-  // 통합된 JSON 배열 종료
-  Serial.println(']'); 
-}
-
-void checkVolt() {
-  int v = analogRead(A3);
-  
-  Serial.print("current vol : ");
-  Serial.println(v);
+  out.println(']');
 }
 
-int checkMotorRunning(int currentIdx) {
-  int sendingMotorState = 0;
-
-  if (current.cup > 0 && currentIdx < current.cup) {
-    sendingMotorState = digitalRead(CUP_MOTOR_OUT[currentIdx]);
-  }
-
-  else if (current.powder > 0 && currentIdx < current.powder) {
-    sendingMotorState = digitalRead(POWDER_MOTOR_OUT[currentIdx]);
+// 현재 설정으로 두 직렬화기를 반복 실행하여 소요 시간과 출력 일치 여부를 보고
+void benchTelemetry() {
+  const int ROUNDS = 200;
+  static char domOut[TELEMETRY_FRAME_SIZE];
+  unsigned long t0, domUs, frameUs;
+  uint64_t ts = deviceMicros();  // 두 출력 비교를 위해 같은 시각 사용
+  int r;
+
+  CaptureSink dom(domOut, sizeof(domOut));
+  t0 = micros();
+  for (r = 0; r < ROUNDS; r++) {
+    dom.len = 0;
+    publishStateJsonDom(dom, ts);
   }
-
-  else if (current.outlet > 0 && currentIdx < current.outlet) {
-    int fwd = digitalRead(OUTLET_FWD_OUT[currentIdx]);
-    int rev = digitalRead(OUTLET_REV_OUT[currentIdx]);
-
-    sendingMotorState = (fwd == 0 && rev == 0) ? 0 : (fwd == 1 ? 1 : -1);
+  domUs = micros() - t0;
+
+  FrameWriter w(txFrame, sizeof(txFrame));
+  t0 = micros();
+  for (r = 0; r < ROUNDS; r++) {
+    w.reset();
+    w.raw('[');
+    // publishStateJson 과 동일한 경로를 전송 없이 측정
+    writeStateObjects(w, ts);
+    w.lit("]\r\n");
   }
-
-  return sendingMotorState;
+  frameUs = micros() - t0;
+
+  bool same = (dom.len == w.length()) && memcmp(domOut, w.data(), w.length()) == 0;
+
+  Link.print("bench telemetry bytes=");
+  Link.print((unsigned long)w.length());
+  Link.print(" dom_us=");
+  Link.print(domUs / ROUNDS);
+  Link.print(" frame_us=");
+  Link.print(frameUs / ROUNDS);
+  Link.print(" identical=");
+  Link.println(same ? 1 : 0);
 }
+#endif // TELEMETRY_BENCH
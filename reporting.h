@@ -7,6 +7,7 @@ void readAllSensors();
 void checkVolt();
 int checkMotorRunning(int currentIdx);
 void publishStateJson();
+void publishDoorJson();
 
 void handleEncoderA();
 void handleEncoderB();
@@ -15,4 +16,21 @@ void reportEncoderDebug(unsigned long currentMillis);
 // 에러 전송
 void sendError(const char* device, int control, const char* errorMsg);
 
+// 동작 마감 초과 (supervisor) 전송
+void sendFault(const char* device, int control, const char* motion, unsigned long elapsedMs);
+
+// 장비 이벤트 (조리 완료 등), key 가 있으면 숫자 값 하나를 함께 보냄
+void sendEvent(const char* device, int control, const char* event,
+               const char* key = nullptr, long value = 0);
+
+// 부팅 알림
+void sendBoot();
+
+// 시각 동기 (ping) 응답
+void sendPong(long seq);
+
+#ifdef TELEMETRY_BENCH
+void benchTelemetry();
+#endif
+
 #endif // REPORTING_H
\ No newline at end of file
@@ -1,17 +1,24 @@
 #include <Arduino.h>
-#include <ArduinoJson.h>
 
 // 모듈 헤더파일 포함
 #include "config.h"     // 핀맵, 상수
 #include "state.h"      // Setting/State 구조체, 전역변수 선언
 #include "protocol.h"   // 수신 명령
 #include "reporting.h"  // 상태 보고
+#include "transport.h"  // 송수신 경로
+#include "supervisor.h" // 동작 마감 감시, watchdog
+#include "scheduler.h"  // 고정 주기 작업
+#include "devclock.h"   // 기기 시각 (프레임 ts)
+#include "dosing.h"     // 스프 정량 배출
+#include "sensestat.h"  // 보고 구간 센서 통계
+#include "memstat.h"    // 메모리 / 버퍼 사용량
 
 // ===== 전역 변수 정의 =====
 Setting current;
 State state;
-String rx;
-unsigned long lastPublishMs = 0;
+char rx[RX_BUFFER_SIZE + 1];   // 수신 패킷 버퍼 (제자리 파싱용, '\0' 포함)
+size_t rxLen = 0;
+bool rxOverflow = false;
 
 // ===== 엔코더 관련 설정 =====
 const int ENCODER_A_PIN = 2;
@@ -24,22 +31,18 @@ volatile long encoderCount = 0;
 volatile int  direction = 0;
 long lastCount = 0;
 
-void setup() {
-  Serial.begin(115200);
-  while (!Serial) { ; }
+// =======================================================
+// === 스케줄러 작업 (config.h 의 주기/우선순위)
+// =======================================================
 
-#ifdef ARDUINO_ARCH_SAM
-  analogReadResolution(10);
-#endif
+// 1. 제어: 리밋 센서 감시, 동작 마감 감시 (고정 고속 주기)
+void taskControl() {
+  deviceMicros();  // micros() wrap 을 놓치지 않도록 매 주기 갱신
+  Link.pumpTx();   // 송신 큐를 드라이버 여유만큼 (상태 프레임을 여러 틱에 나눠 보냄)
 
-  pinMode(DOOR_SENSOR1_PIN, INPUT);
-  pinMode(DOOR_SENSOR2_PIN, INPUT);
-
-  Serial.println(F("[{\"boot\":\"ready\"\"}]"));
-  lastPublishMs = millis();
-}
+  // 마감 지난 동작 차단, 정상일 때만 watchdog 갱신
+  serviceSupervisor();
 
-void loop() {
   if (current.cup > 0) {
     checkCupDispense();  
   }
@@ -50,71 +53,100 @@ void loop() {
   }
   if (current.powder > 0) {
     checkPowderDispense(); 
+    checkPowderDose();
   }
   if (current.outlet > 0) {
     checkOutlet();
   }
+  if (current.cooker > 0) {
+    checkCooker();
+  }
+}
 
-  /*
-  Serial.print("면 배출 상한 센서 : ");
-  Serial.println(digitalRead(8));
-  Serial.print("면 배출 하한 센서 : ");
-  Serial.println(digitalRead(9));
-  Serial.print("면 상승 상한 센서 : ");
-  Serial.println(digitalRead(10));
-  Serial.print("면 상승 하한 센서 :");
-  Serial.println(digitalRead(11));
-  */
-
-  // ================================================
-  // 2. [실시간] JSON 명령 수신 (대괄호 [] 지원 수정됨)
-  // ================================================
-  while (Serial.available()) {
-    char c = Serial.read();
+// 2. [실시간] JSON 명령 수신 (대괄호 [] 지원 수정됨)
+void taskRx() {
+  noteRxBacklog(Link.available());
+  while (Link.available()) {
+    char c = Link.read();
 
     // 1. 시작 문자 '[' 감지 시: 버퍼 초기화 (새로운 패킷 시작으로 간주)
     if (c == '[') {
-      rx = ""; 
+      rxLen = 0;
+      rxOverflow = false;
       continue; 
     }
 
     // 2. 종료 문자 ']' 감지 시: 명령 실행
     if (c == ']') {
-      if (rx.length() > 0) {
-        parseAndDispatch(rx.c_str()); // 수신된 문자열 파싱
-        rx = ""; // 버퍼 비우기
+      if (rxOverflow) {
+        sendError("system", 0, "rx buffer overflow");
+      } else if (rxLen > 0) {
+        rx[rxLen] = '\0';
+        parseAndDispatch(rx); // 수신된 문자열 파싱 (버퍼 제자리)
       }
+      rxLen = 0; // 버퍼 비우기
+      rxOverflow = false;
     } 
     // 3. 그 외 문자는 버퍼에 저장 (단, '['는 위에서 처리했으므로 제외됨)
-    else {
-      rx += c;
+    else if (rxLen < RX_BUFFER_SIZE) {
+      rx[rxLen++] = c;
+      noteRxLen(rxLen);
+    } else {
+      rxOverflow = true;
     }
   }
+}
 
-  unsigned long now = millis();
-  if (now - lastPublishMs >= PUBLISH_INTERVAL_MS) {
-    lastPublishMs = now;
+// 3. 센서 연속 샘플 (보고 구간 최소/최대/평균, 변화 횟수)
+void taskSample() {
+  sampleSensors();
+}
 
-    if (current.cup > 0 || current.ramen > 0 || current.powder > 0 || current.cooker > 0 || current.outlet > 0) {
-      readAllSensors(); // Reporting.cpp 에 정의됨
-      // Serial.print("######################### ");
-      // Serial.print(state.cup_stock[0]);
-      // Serial.println(" #########################");
-      publishStateJson();
-    } else {
-      // setting 안된 경우에 보냄
-      state.door_sensor1 = digitalRead(DOOR_SENSOR1_PIN);
-      state.door_sensor2 = digitalRead(DOOR_SENSOR2_PIN);
-
-      StaticJsonDocument<128> doorDoc;
-      doorDoc["device"] = "door";
-      doorDoc["sensor1"] = state.door_sensor1;
-      doorDoc["sensor2"] = state.door_sensor2;
-      
-      // 수정: 대괄호 추가
-      Serial.print('[');
-      serializeJson(doorDoc, Serial);
-      Serial.println(']');
-    }
+// 4. 센서 읽기
+void taskSense() {
+  if (current.cup > 0 || current.ramen > 0 || current.powder > 0 || current.cooker > 0 || current.outlet > 0) {
+    readAllSensors(); // Reporting.cpp 에 정의됨
+  } else {
+    state.door_sensor1 = digitalRead(DOOR_SENSOR1_PIN);
+    state.door_sensor2 = digitalRead(DOOR_SENSOR2_PIN);
   }
-}
\ No newline at end of file
+}
+
+// 5. 상태 보고
+void taskPublish() {
+  if (current.cup > 0 || current.ramen > 0 || current.powder > 0 || current.cooker > 0 || current.outlet > 0) {
+    publishStateJson();
+  } else {
+    // setting 안된 경우에 보냄
+    publishDoorJson();
+  }
+  reportSchedulerOverruns();
+  reportMemStats();
+}
+
+void setup() {
+  initMemStats();  // 스택 칠하기는 다른 초기화보다 먼저
+  Link.begin();  // UART / 네이티브 USB / 호스트 PTY (config.h TRANSPORT)
+  startWatchdog();
+
+#ifdef ARDUINO_ARCH_SAM
+  analogReadResolution(10);
+#endif
+
+  pinMode(DOOR_SENSOR1_PIN, INPUT);
+  pinMode(DOOR_SENSOR2_PIN, INPUT);
+
+  resetSenseStats();
+  sendBoot();
+
+  addTask("control", taskControl, CONTROL_PERIOD_MS, 0);
+  addTask("rx", taskRx, RX_PERIOD_MS, 1);
+  addTask("sample", taskSample, SAMPLE_PERIOD_MS, 2);
+  addTask("sense", taskSense, SENSE_PERIOD_MS, 3);
+  addTask("publish", taskPublish, PUBLISH_INTERVAL_MS, 4);
+  startScheduler();
+}
+
+void loop() {
+  runScheduler();
+}
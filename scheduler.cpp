@@ -0,0 +1,168 @@
+#include <Arduino.h>
+#include "scheduler.h"
+#include "config.h"
+#include "frame.h"
+#include "transport.h"
+#include "devclock.h"
+
+struct Task {
+  const char* name;
+  TaskFn fn;
+  uint16_t period;            // 틱 단위
+  uint8_t priority;
+  volatile uint16_t countdown;
+  volatile bool ready;        // ISR 이 세우고 runScheduler 가 내림
+  volatile uint32_t overruns; // 실행 대기 중에 다시 주기가 온 횟수
+  uint32_t runs;
+  uint32_t maxUs;             // 1회 최대 실행 시간
+};
+
+static Task tasks[MAX_TASKS];
+static uint8_t taskCount = 0;
+static uint32_t reportedOverruns = 0;
+static unsigned long lastOverrunReportMs = 0;
+
+int addTask(const char* name, TaskFn fn, uint16_t periodMs, uint8_t priority) {
+  if (taskCount >= MAX_TASKS) return -1;
+
+  // 우선순위 순으로 정렬된 상태 유지 (같은 우선순위는 등록 순)
+  uint8_t pos = taskCount;
+  while (pos > 0 && tasks[pos - 1].priority > priority) {
+    tasks[pos] = tasks[pos - 1];
+    pos--;
+  }
+
+  Task& t = tasks[pos];
+  t.name = name;
+  t.fn = fn;
+  t.period = periodMs ? periodMs : 1;
+  t.priority = priority;
+  t.countdown = t.period;
+  t.ready = false;
+  t.overruns = 0;
+  t.runs = 0;
+  t.maxUs = 0;
+  taskCount++;
+  return pos;
+}
+
+// 틱 1회: 주기가 된 작업을 실행 대기로 표시 (ISR 문맥)
+static void schedulerTick() {
+  for (uint8_t i = 0; i < taskCount; i++) {
+    Task& t = tasks[i];
+    if (--t.countdown == 0) {
+      t.countdown = t.period;
+      if (t.ready) t.overruns++;
+      else t.ready = true;
+    }
+  }
+}
+
+#ifdef ARDUINO_ARCH_SAM
+// TC1 채널 0 (TC3_IRQn), MCK/2 = 42MHz 클럭으로 RC 비교 인터럽트
+void TC3_Handler() {
+  TC_GetStatus(TC1, 0);  // 상태 레지스터 읽어 인터럽트 해제
+  schedulerTick();
+}
+
+void startScheduler() {
+  pmc_set_writeprotect(false);
+  pmc_enable_periph_clk(ID_TC3);
+  TC_Configure(TC1, 0, TC_CMR_WAVE | TC_CMR_WAVSEL_UP_RC | TC_CMR_TCCLKS_TIMER_CLOCK1);
+  TC_SetRC(TC1, 0, VARIANT_MCK / 2 / SCHED_TICK_HZ);
+  TC_Start(TC1, 0);
+  TC1->TC_CHANNEL[0].TC_IER = TC_IER_CPCS;
+  TC1->TC_CHANNEL[0].TC_IDR = ~TC_IER_CPCS;
+  NVIC_SetPriority(TC3_IRQn, 15);  // 가장 낮은 우선순위 (리밋 스위치 등 다른 인터럽트 우선)
+  NVIC_EnableIRQ(TC3_IRQn);
+}
+
+static void pollTicks() {}
+#else
+// 하드웨어 타이머가 없는 빌드(호스트): micros() 경과로 틱을 만든다
+// micros() 는 32비트로 넘어가므로 차이도 32비트로 잘라 계산한다
+// (호스트의 unsigned long 은 64비트라 그대로 빼면 wrap 뒤 거대한 값이 됨)
+static uint32_t lastTickUs = 0;
+
+void startScheduler() {
+  lastTickUs = micros();
+}
+
+static void pollTicks() {
+  const uint32_t tickUs = 1000000UL / SCHED_TICK_HZ;
+  while ((uint32_t)(micros() - lastTickUs) >= tickUs) {
+    lastTickUs += tickUs;
+    schedulerTick();
+  }
+}
+#endif
+
+void runScheduler() {
+  pollTicks();
+
+  // 실행 대기 작업을 우선순위 순으로 모두 처리한다.
+  // 작업 하나가 끝날 때마다 맨 앞부터 다시 보므로, 그 사이 틱이 세운
+  // 제어 작업이 낮은 우선순위 작업보다 먼저 실행된다.
+  uint8_t i = 0;
+  while (i < taskCount) {
+    Task& t = tasks[i];
+    if (!t.ready) {
+      i++;
+      continue;
+    }
+
+    noInterrupts();
+    t.ready = false;
+    interrupts();
+
+    uint32_t t0 = micros();
+    t.fn();
+    uint32_t dt = (uint32_t)(micros() - t0);
+
+    t.runs++;
+    if (dt > t.maxUs) t.maxUs = dt;
+
+    pollTicks();
+    i = 0;
+  }
+}
+
+void sendSchedulerStats() {
+  char buf[96 * MAX_TASKS];
+  FrameWriter w(buf, sizeof(buf));
+
+  w.raw('[');
+  for (uint8_t i = 0; i < taskCount; i++) {
+    const Task& t = tasks[i];
+    if (i) w.raw(',');
+    w.lit("{\"device\":\"sched\",\"task\":");
+    w.str(t.name);
+    w.lit(",\"period\":");
+    w.uinteger(t.period);
+    w.lit(",\"runs\":");
+    w.uinteger(t.runs);
+    w.lit(",\"overrun\":");
+    w.uinteger(t.overruns);
+    w.lit(",\"max_us\":");
+    w.uinteger(t.maxUs);
+    if (i == 0) {
+      w.lit(",\"ts\":");
+      w.uinteger64(deviceMicros());
+    }
+    w.raw('}');
+  }
+  w.lit("]\r\n");
+  w.flushTo(Link);
+}
+
+void reportSchedulerOverruns() {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < taskCount; i++) total += tasks[i].overruns;
+
+  unsigned long now = millis();
+  if (total != reportedOverruns && now - lastOverrunReportMs >= 1000) {
+    reportedOverruns = total;
+    lastOverrunReportMs = now;
+    sendSchedulerStats();
+  }
+}
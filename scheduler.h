@@ -0,0 +1,31 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+// =======================================================
+// === 고정 주기 협조형 스케줄러 (타이머 인터럽트 틱)
+// =======================================================
+// 하드웨어 타이머가 SCHED_TICK_HZ 로 틱을 만들고, 틱 ISR 은 주기가 된 작업을
+// "실행 대기" 로 표시만 한다. 실제 실행은 loop() 의 runScheduler() 가
+// 우선순위(숫자가 작을수록 먼저) 순으로 하나씩 한다.
+// 이전 실행 대기가 처리되기 전에 다시 주기가 오면 overrun 으로 센다.
+
+typedef void (*TaskFn)();
+
+// 작업 등록 (setup 에서). periodMs 는 틱(1ms) 단위, 반환값은 작업 번호 (-1: 가득 참)
+int addTask(const char* name, TaskFn fn, uint16_t periodMs, uint8_t priority);
+
+// 틱 타이머 시작 (작업 등록 후 1회)
+void startScheduler();
+
+// loop() 에서 반복 호출
+void runScheduler();
+
+// 작업별 실행 횟수 / overrun / 최대 실행 시간 프레임 전송
+void sendSchedulerStats();
+
+// overrun 이 새로 생겼으면 (최대 1초에 한 번) 통계 전송
+void reportSchedulerOverruns();
+
+#endif // SCHEDULER_H
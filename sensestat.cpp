@@ -0,0 +1,147 @@
+#include <Arduino.h>
+#include "sensestat.h"
+#include "config.h"
+#include "state.h"
+
+SenseWindow senseWindow;
+
+static void clearAnalog(AnalogWindow& a) {
+  a.min = 0;
+  a.max = 0;
+  a.sum = 0;
+  a.count = 0;
+}
+
+static void addAnalog(AnalogWindow& a, int v) {
+  if (a.count == 0 || v < a.min) a.min = v;
+  if (a.count == 0 || v > a.max) a.max = v;
+  a.sum += v;
+  if (a.count < 0xFFFF) a.count++;
+}
+
+static void addLevel(EdgeWindow& e, int v) {
+  int8_t level = v ? 1 : 0;
+  if (e.level >= 0 && e.level != level && e.edges < 0xFFFF) e.edges++;
+  e.level = level;
+}
+
+static void clearAnalogs(AnalogWindow* a, uint8_t n) {
+  for (uint8_t i = 0; i < n; i++) clearAnalog(a[i]);
+}
+
+static void clearEdges(EdgeWindow* e, uint8_t n, bool forgetLevel) {
+  for (uint8_t i = 0; i < n; i++) {
+    e[i].edges = 0;
+    if (forgetLevel) e[i].level = -1;
+  }
+}
+
+static void clearWindow(bool forgetLevel) {
+  SenseWindow& s = senseWindow;
+  clearAnalogs(s.cup_amp, MAX_CUP);
+  clearEdges(s.cup_stock, MAX_CUP, forgetLevel);
+  clearEdges(s.cup_dispense, MAX_CUP, forgetLevel);
+  clearAnalogs(s.ramen_amp, MAX_RAMEN);
+  clearEdges(s.ramen_detect, MAX_RAMEN, forgetLevel);
+  clearAnalogs(s.powder_amp, MAX_POWDER);
+  clearAnalogs(s.cooker_amp, MAX_COOKER);
+  clearAnalogs(s.outlet_amp, MAX_OUTLET);
+  clearAnalogs(s.outlet_load, MAX_OUTLET);
+  clearEdges(&s.door_sensor1, 1, forgetLevel);
+  clearEdges(&s.door_sensor2, 1, forgetLevel);
+}
+
+void resetSenseStats() {
+  clearWindow(true);
+}
+
+void nextSenseWindow() {
+  clearWindow(false);
+}
+
+void sampleSensors() {
+  SenseWindow& s = senseWindow;
+  uint8_t i;
+
+  for (i = 0; i < current.cup; i++) {
+    addAnalog(s.cup_amp[i], analogRead(CUP_CURR_AIN[i]));
+    addLevel(s.cup_stock[i], digitalRead(CUP_STOCK_IN[i]));
+    addLevel(s.cup_dispense[i], digitalRead(CUP_ROT_IN[i]));
+  }
+
+  for (i = 0; i < current.ramen; i++) {
+    addAnalog(s.ramen_amp[i], analogRead(RAMEN_EJ_CURR_AIN[i]));
+    addLevel(s.ramen_detect[i], digitalRead(RAMEN_PRESENT_IN[i]));  // 디바운스 전 원신호
+  }
+
+  for (i = 0; i < current.powder; i++) {
+    addAnalog(s.powder_amp[i], analogRead(POWDER_CURR_AIN[i]));  // 필터 전 원신호
+  }
+
+  for (i = 0; i < current.cooker; i++) {
+    addAnalog(s.cooker_amp[i], analogRead(COOKER_CURR_AIN[i]));
+  }
+
+  for (i = 0; i < current.outlet; i++) {
+    addAnalog(s.outlet_amp[i], analogRead(OUTLET_CURR_AIN[i]));
+    // HX711 은 변환이 끝났을 때만 읽는다 (배출구 레인이 쓰는 outlet_loadcell 도 여기서 갱신)
+    if (outletScale[i].is_ready()) {
+      state.outlet_loadcell[i] = (int)outletScale[i].get_units(1);
+      addAnalog(s.outlet_load[i], state.outlet_loadcell[i]);
+    }
+  }
+
+  addLevel(s.door_sensor1, digitalRead(DOOR_SENSOR1_PIN));
+  addLevel(s.door_sensor2, digitalRead(DOOR_SENSOR2_PIN));
+}
+
+long analogWindowMean(const AnalogWindow& a) {
+  if (a.count == 0) return 0;
+  long half = a.count / 2;  // 반올림 (로드셀은 음수도 있음)
+  return (a.sum >= 0 ? a.sum + half : a.sum - half) / a.count;
+}
+
+bool analogWindowFlat(const AnalogWindow& a) {
+  return a.count == 0 || (a.min == 0 && a.max == 0);
+}
+
+void writeAnalogWindow(FrameWriter& w, const char* key, const AnalogWindow& a) {
+  if (analogWindowFlat(a)) return;
+  w.raw(',');
+  w.str(key);
+  w.raw(':');
+  if (a.min == a.max) {
+    w.integer(a.min);
+    return;
+  }
+  w.raw('[');
+  w.integer(a.min);
+  w.raw(',');
+  w.integer(a.max);
+  w.raw(',');
+  w.integer(analogWindowMean(a));
+  w.raw(']');
+}
+
+void writeCountedWindow(FrameWriter& w, const char* key, const AnalogWindow& a) {
+  if (a.count == 0) return;
+  w.raw(',');
+  w.str(key);
+  w.lit(":[");
+  w.integer(a.min);
+  w.raw(',');
+  w.integer(a.max);
+  w.raw(',');
+  w.integer(analogWindowMean(a));
+  w.raw(',');
+  w.uinteger(a.count);
+  w.raw(']');
+}
+
+void writeEdgeWindow(FrameWriter& w, const char* key, const EdgeWindow& e) {
+  if (e.edges == 0) return;
+  w.raw(',');
+  w.str(key);
+  w.raw(':');
+  w.uinteger(e.edges);
+}
@@ -0,0 +1,75 @@
+#ifndef SENSESTAT_H
+#define SENSESTAT_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "frame.h"
+
+// =======================================================
+// === 보고 구간 센서 통계 (publish 사이 연속 샘플)
+// =======================================================
+// 상태 프레임의 값은 보고 시점 한 번의 샘플이라 그 사이의 전류 튐, 짧은 감지는
+// 보이지 않는다. 샘플 작업(SENSE_SAMPLE_PERIOD_MS)이 채널마다 계속 읽어
+// 보고 구간(publish 한 번) 동안의 최소/최대/평균과 디지털 입력의 변화(edge)
+// 횟수를 모으고, 상태 프레임을 보낸 뒤 구간을 비운다.
+// 100ms 마다 나가는 프레임이 링크 대역(115200bps ≒ 11.5KB/s)을 넘지 않도록 짧게 쓴다:
+//   - 구간 내내 0 (모터 정지 등) 이거나 샘플이 없으면 필드 생략
+//   - 구간 내내 같은 값이면 "key":v, 아니면 "key":[min,max,mean]
+//   - 변화 횟수가 0 이면 필드 생략
+// 아날로그 전류는 샘플 수가 구간마다 같아 (PUBLISH_INTERVAL_MS / SAMPLE_PERIOD_MS 개)
+// 보내지 않는다. 로드셀은 HX711 변환이 끝난 샘플만 들어가 구간마다 다르므로
+// 샘플이 있으면 0 이어도 "key":[min,max,mean,count] 로 샘플 수까지 보낸다.
+// 샘플 / 보고 모두 loop 문맥 (스케줄러 작업) 에서만 호출한다.
+
+// 아날로그 채널 한 구간
+struct AnalogWindow {
+  int min;
+  int max;
+  long sum;
+  uint16_t count;
+};
+
+// 디지털 입력 한 구간 (level 은 구간을 넘어 유지)
+struct EdgeWindow {
+  uint16_t edges;
+  int8_t level;   // 직전 샘플 (-1: 아직 없음)
+};
+
+struct SenseWindow {
+  AnalogWindow cup_amp[MAX_CUP];
+  EdgeWindow cup_stock[MAX_CUP];
+  EdgeWindow cup_dispense[MAX_CUP];
+  AnalogWindow ramen_amp[MAX_RAMEN];
+  EdgeWindow ramen_detect[MAX_RAMEN];
+  AnalogWindow powder_amp[MAX_POWDER];
+  AnalogWindow cooker_amp[MAX_COOKER];
+  AnalogWindow outlet_amp[MAX_OUTLET];
+  AnalogWindow outlet_load[MAX_OUTLET];  // 로드셀 (변환 완료된 샘플만)
+  EdgeWindow door_sensor1;
+  EdgeWindow door_sensor2;
+};
+
+extern SenseWindow senseWindow;
+
+// 장비 구성이 바뀔 때: 구간과 직전 레벨 모두 초기화
+void resetSenseStats();
+
+// 샘플 작업: 구성된 채널을 한 번씩 읽어 구간에 누적
+void sampleSensors();
+
+// 상태 프레임 전송 후: 다음 구간 시작 (직전 레벨은 유지)
+void nextSenseWindow();
+
+// 구간 평균 (샘플이 없으면 0)
+long analogWindowMean(const AnalogWindow& a);
+
+// 보낼 것이 없는 구간 (샘플 없음, 또는 모두 0)
+bool analogWindowFlat(const AnalogWindow& a);
+
+// 프레임 필드: ,"key":v 또는 ,"key":[min,max,mean] / ,"key":edges (위 생략 규칙)
+void writeAnalogWindow(FrameWriter& w, const char* key, const AnalogWindow& a);
+// 샘플 수가 구간마다 다른 채널 (로드셀): ,"key":[min,max,mean,count] (샘플 없으면 생략)
+void writeCountedWindow(FrameWriter& w, const char* key, const AnalogWindow& a);
+void writeEdgeWindow(FrameWriter& w, const char* key, const EdgeWindow& e);
+
+#endif // SENSESTAT_H
@@ -27,7 +27,6 @@ struct State {
   int powder_amp[MAX_POWDER] = {0};
   int powder_dispense[MAX_POWDER] = {0};
   // Cooker
-  int cooker_amp[MAX_COOKER] = {0};
   int cooker_work[MAX_COOKER] = {0};
   // Outlet
   int outlet_amp[MAX_OUTLET] = {0};
@@ -39,8 +38,8 @@ struct State {
   int door_sensor2 = 0;
 };
 
-extern long startCupReleaseTime[MAX_CUP];
-extern long cupReleaseInterval;
+extern unsigned long startCupReleaseTime[MAX_CUP];
+extern unsigned long cupReleaseInterval;
 
 extern Setting current;
 extern State state;
@@ -56,8 +55,40 @@ enum RamenEjectState {
   EJECT_RETURNING
 };
 
-extern RamenEjectState ramenEjectStatus;
+extern RamenEjectState ramenEjectStatus[MAX_RAMEN];  // 장비별 배출 상태
+
+// 조리 프로그램: 급수(water) -> 가열(timer) -> 자동 정지
+enum CookPhase {
+  COOK_IDLE,
+  COOK_FILLING,
+  COOK_HEATING
+};
+
+struct CookProgram {
+  CookPhase phase = COOK_IDLE;
+  unsigned long phaseStart = 0;  // 현재 단계 시작 시각 (millis)
+  unsigned long fillMs = 0;      // 급수 시간 (water 환산)
+  unsigned long heatMs = 0;      // 가열 시간, 0 이면 stopcook 까지 계속
+};
+
+extern CookProgram cookers[MAX_COOKER];
 
 extern HX711 outletScale[MAX_OUTLET];
 
+// 배출구 레인: 로드셀로 그릇 놓임 -> 자동 열기, 가져감 -> 자동 닫기
+enum OutletLanePhase {
+  LANE_EMPTY,    // 그릇 없음
+  LANE_WAITING,  // 그릇 놓임, 문 열고 손님 대기
+  LANE_CLOSING   // 가져감, 문 닫는 중
+};
+
+struct OutletLane {
+  OutletLanePhase phase = LANE_EMPTY;
+  bool holding = false;          // 놓임 / 빠짐 조건이 유지되는 중
+  unsigned long holdStart = 0;   // 조건 시작 시각 (millis)
+  unsigned long placedAt = 0;    // 그릇 놓인 시각 (millis)
+};
+
+extern OutletLane outletLanes[MAX_OUTLET];
+
 #endif // STATE_H
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include <Arduino.h>
+#include "store.h"
+
+static const uint32_t STORE_MAGIC = 0x31595442;  // "BTY1"
+static const size_t PAGE_SIZE = 256;
+
+struct StoreHeader {
+  uint32_t magic;
+  uint32_t len;
+  uint32_t sum;
+};
+
+// FNV-1a
+static uint32_t checksum(const uint8_t* p, size_t n) {
+  uint32_t h = 2166136261UL;
+  while (n--) {
+    h ^= *p++;
+    h *= 16777619UL;
+  }
+  return h;
+}
+
+static void buildPage(uint32_t* page, const void* data, size_t len) {
+  memset(page, 0xFF, PAGE_SIZE);
+  StoreHeader h = { STORE_MAGIC, (uint32_t)len, checksum((const uint8_t*)data, len) };
+  memcpy(page, &h, sizeof(h));
+  memcpy((uint8_t*)page + sizeof(h), data, len);
+}
+
+static bool parsePage(const uint8_t* page, void* data, size_t len) {
+  StoreHeader h;
+  memcpy(&h, page, sizeof(h));
+  if (h.magic != STORE_MAGIC || h.len != len) return false;
+  if (checksum(page + sizeof(h), len) != h.sum) return false;
+  memcpy(data, page + sizeof(h), len);
+  return true;
+}
+
+#ifdef ARDUINO_ARCH_SAM
+// bank1 (EFC1) 마지막 페이지부터 거꾸로 슬롯 배정. 코드는 bank0 에서 실행되므로
+// bank1 을 쓰는 동안에도 명령을 읽을 수 있다.
+static uint32_t slotAddr(StoreSlot slot) {
+  return IFLASH1_ADDR + IFLASH1_SIZE - (uint32_t)(slot + 1) * IFLASH1_PAGE_SIZE;
+}
+
+bool loadStore(StoreSlot slot, void* data, size_t len) {
+  if (len > STORE_DATA_MAX) return false;
+  return parsePage((const uint8_t*)slotAddr(slot), data, len);
+}
+
+bool saveStore(StoreSlot slot, const void* data, size_t len) {
+  if (len > STORE_DATA_MAX) return false;
+
+  uint32_t page[PAGE_SIZE / 4];
+  buildPage(page, data, len);
+
+  // 페이지 주소에 써서 래치 버퍼를 채운 뒤 ROM 의 IAP 로 지우기+쓰기(EWP)
+  uint32_t addr = slotAddr(slot);
+  volatile uint32_t* latch = (volatile uint32_t*)addr;
+  for (size_t i = 0; i < PAGE_SIZE / 4; i++) latch[i] = page[i];
+
+  typedef uint32_t (*IapFn)(uint32_t efcIndex, uint32_t fcr);
+  IapFn iap = *(IapFn*)(IROM_ADDR + 8);
+  uint32_t pageNo = (addr - IFLASH1_ADDR) / IFLASH1_PAGE_SIZE;
+
+  // 지우기+쓰기(수 ms) 동안 인터럽트를 막으므로 1kHz 스케줄러 틱과 리밋 센서 ISR 도
+  // 멈춘다 (틱은 overrun 으로 세고, 리밋 입력은 끝난 뒤에야 처리). 그래서 호출 쪽은
+  // 해당 장비 모터가 모두 멈춰 있을 때만 저장한다 (dosing: powderMotorsIdle).
+  noInterrupts();
+  uint32_t fsr = iap(1, EEFC_FCR_FKEY(0x5A) | EEFC_FCR_FARG(pageNo) | EEFC_FCR_FCMD(0x03));
+  interrupts();
+
+  return (fsr & (EEFC_FSR_FCMDE | EEFC_FSR_FLOCKE)) == 0;
+}
+#else
+#include <stdio.h>
+#include <stdlib.h>
+
+// 호스트: BOTTY_STORE 파일의 slot*256 위치, 파일이 없으면 메모리
+static uint8_t memPages[STORE_SLOT_COUNT][PAGE_SIZE];
+
+bool loadStore(StoreSlot slot, void* data, size_t len) {
+  if (len > STORE_DATA_MAX) return false;
+
+  uint8_t page[PAGE_SIZE];
+  const char* path = getenv("BOTTY_STORE");
+  if (!path) return parsePage(memPages[slot], data, len);
+
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  bool ok = fseek(f, (long)slot * PAGE_SIZE, SEEK_SET) == 0 && fread(page, 1, PAGE_SIZE, f) == PAGE_SIZE;
+  fclose(f);
+  return ok && parsePage(page, data, len);
+}
+
+bool saveStore(StoreSlot slot, const void* data, size_t len) {
+  if (len > STORE_DATA_MAX) return false;
+
+  uint32_t page[PAGE_SIZE / 4];
+  buildPage(page, data, len);
+  const char* path = getenv("BOTTY_STORE");
+  if (!path) {
+    memcpy(memPages[slot], page, PAGE_SIZE);
+    return true;
+  }
+
+  FILE* f = fopen(path, "r+b");
+  if (!f) f = fopen(path, "w+b");
+  if (!f) return false;
+  bool ok = fseek(f, (long)slot * PAGE_SIZE, SEEK_SET) == 0 && fwrite(page, 1, PAGE_SIZE, f) == PAGE_SIZE;
+  fclose(f);
+  return ok;
+}
+#endif
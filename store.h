@@ -0,0 +1,28 @@
+#ifndef STORE_H
+#define STORE_H
+
+#include <Arduino.h>
+
+// =======================================================
+// === 비휘발 저장 (재부팅 후에도 유지되는 작은 데이터)
+// =======================================================
+// Due 에는 EEPROM 이 없어 내부 플래시 bank1 끝쪽 페이지를 슬롯 하나당 한 페이지씩 쓴다.
+// 페이지 = 머리말(magic, 길이, 체크섬) + 데이터. 길이나 체크섬이 맞지 않으면 읽기 실패로
+// 보고 호출 쪽이 기본값을 쓴다 (처음 부팅, 구조체 변경 시).
+// 스케치를 새로 업로드하면 플래시 전체가 지워지므로 저장값도 초기화된다.
+// 호스트 빌드는 환경변수 BOTTY_STORE 파일에 저장한다 (없으면 메모리에만).
+
+enum StoreSlot {
+  STORE_POWDER_MODEL = 0,   // 스프 배출량 모델 (dosing)
+  STORE_SLOT_COUNT
+};
+
+const size_t STORE_DATA_MAX = 256 - 12;  // 페이지 - 머리말
+
+bool loadStore(StoreSlot slot, void* data, size_t len);
+
+// 페이지 지우기+쓰기 1회 (수 ms, 그동안 인터럽트 금지 - 스케줄러 틱, 리밋 ISR 도 멈춤).
+// 자주 부르지 않고, 모터가 돌지 않을 때만 부른다.
+bool saveStore(StoreSlot slot, const void* data, size_t len);
+
+#endif // STORE_H
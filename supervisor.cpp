@@ -0,0 +1,161 @@
+#include <Arduino.h>
+#include "supervisor.h"
+#include "config.h"
+#include "reporting.h"
+
+// 감시 중인 동작 하나
+struct Motion {
+  uint8_t pin;
+  uint8_t idx;
+  const char* device;
+  const char* motion;
+  unsigned long startMs;
+  unsigned long deadlineMs;
+  MotionAbortFn onAbort;
+};
+
+static const uint8_t PIN_SLOTS = 80;    // Due 핀 번호 범위
+static const uint8_t NO_SLOT = 0xFF;
+
+static Motion motions[MAX_MOTIONS];
+static uint8_t slotOfPin[PIN_SLOTS];    // pin -> motions[] 위치
+static uint8_t heap[MAX_MOTIONS];       // 마감 순 min-heap (motions[] 위치)
+static uint8_t heapPos[MAX_MOTIONS];    // motions[] 위치 -> heap[] 위치
+static uint8_t heapCount = 0;
+static bool slotsReady = false;
+
+// millis() 가 넘어가도(약 49일) 올바른 선후 비교
+static bool earlier(unsigned long a, unsigned long b) {
+  return (long)(a - b) < 0;
+}
+
+static void initSlots() {
+  for (uint8_t p = 0; p < PIN_SLOTS; p++) slotOfPin[p] = NO_SLOT;
+  slotsReady = true;
+}
+
+static void heapSwap(uint8_t a, uint8_t b) {
+  uint8_t t = heap[a];
+  heap[a] = heap[b];
+  heap[b] = t;
+  heapPos[heap[a]] = a;
+  heapPos[heap[b]] = b;
+}
+
+static void siftUp(uint8_t i) {
+  while (i > 0) {
+    uint8_t parent = (i - 1) / 2;
+    if (!earlier(motions[heap[i]].deadlineMs, motions[heap[parent]].deadlineMs)) break;
+    heapSwap(i, parent);
+    i = parent;
+  }
+}
+
+static void siftDown(uint8_t i) {
+  for (;;) {
+    uint8_t l = 2 * i + 1, r = l + 1, m = i;
+    if (l < heapCount && earlier(motions[heap[l]].deadlineMs, motions[heap[m]].deadlineMs)) m = l;
+    if (r < heapCount && earlier(motions[heap[r]].deadlineMs, motions[heap[m]].deadlineMs)) m = r;
+    if (m == i) break;
+    heapSwap(i, m);
+    i = m;
+  }
+}
+
+// heap[i] 제거 후 그 motion 슬롯을 비운다
+static void heapRemove(uint8_t i) {
+  uint8_t slot = heap[i];
+  slotOfPin[motions[slot].pin] = NO_SLOT;
+
+  heapCount--;
+  if (i != heapCount) {
+    heapSwap(i, heapCount);
+    siftDown(i);
+    siftUp(i);
+  }
+
+  // 빈 슬롯이 배열 끝에 오도록 마지막 슬롯을 옮겨 채운다 (motions[0..heapCount) 유지)
+  uint8_t last = heapCount;
+  if (slot != last) {
+    motions[slot] = motions[last];
+    heap[heapPos[last]] = slot;
+    heapPos[slot] = heapPos[last];
+    slotOfPin[motions[slot].pin] = slot;
+  }
+}
+
+void superviseMotion(uint8_t pin, const char* device, uint8_t idx, const char* motion,
+                     unsigned long timeoutMs, MotionAbortFn onAbort) {
+  if (!slotsReady) initSlots();
+  if (pin >= PIN_SLOTS) return;
+
+  unsigned long now = millis();
+  uint8_t slot = slotOfPin[pin];
+
+  if (slot == NO_SLOT) {
+    if (heapCount >= MAX_MOTIONS) {
+      sendError(device, idx + 1, "supervisor full");
+      return;
+    }
+    slot = heapCount;
+    heap[heapCount] = slot;
+    heapPos[slot] = heapCount;
+    heapCount++;
+    slotOfPin[pin] = slot;
+  }
+
+  Motion& m = motions[slot];
+  m.pin = pin;
+  m.idx = idx;
+  m.device = device;
+  m.motion = motion;
+  m.startMs = now;
+  m.deadlineMs = now + timeoutMs;
+  m.onAbort = onAbort;
+
+  siftUp(heapPos[slot]);
+  siftDown(heapPos[slot]);
+}
+
+void releaseMotion(uint8_t pin) {
+  if (!slotsReady || pin >= PIN_SLOTS) return;
+  uint8_t slot = slotOfPin[pin];
+  if (slot != NO_SLOT) heapRemove(heapPos[slot]);
+}
+
+void serviceSupervisor() {
+  unsigned long now = millis();
+  bool healthy = true;
+
+  // 가장 이른 마감부터, 지난 것만 처리
+  while (heapCount > 0 && !earlier(now, motions[heap[0]].deadlineMs)) {
+    Motion m = motions[heap[0]];
+    heapRemove(0);
+
+    digitalWrite(m.pin, LOW);
+    if (m.onAbort) m.onAbort(m.idx);
+    sendFault(m.device, m.idx + 1, m.motion, now - m.startMs);
+
+    // 출력 차단이 반영되지 않으면 watchdog 을 멈춰 리셋시킨다
+    if (digitalRead(m.pin) == HIGH) healthy = false;
+  }
+
+  if (healthy) feedWatchdog();
+}
+
+#ifdef ARDUINO_ARCH_SAM
+// Due 코어 기본 watchdogSetup() 은 부팅 시 WDT 를 꺼버린다 (WDT_MR 은 한 번만 쓰기 가능).
+// 비워두면 리셋 기본값(약 16초)으로 켜진 채 남고, setup() 에서 원하는 주기로 다시 설정한다.
+void watchdogSetup(void) {}
+
+void startWatchdog() {
+  watchdogEnable(WATCHDOG_TIMEOUT_MS);
+}
+
+void feedWatchdog() {
+  watchdogReset();
+}
+#else
+void startWatchdog() {}
+void feedWatchdog() {}
+#endif
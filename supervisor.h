@@ -0,0 +1,34 @@
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <Arduino.h>
+
+// =======================================================
+// === 동작 마감 감시 (Deadline Supervisor) + 하드웨어 watchdog
+// =======================================================
+// 리밋 센서로 멈추는 모터 출력마다 마감 시각을 걸어두고, 센서 고장 등으로
+// 마감을 넘기면 출력을 끊고 fault 프레임을 보낸다.
+// 마감은 min-heap 으로 관리하므로 loop 당 비용은 감시 채널 수와 무관하게
+// 가장 이른 마감 하나만 확인한다. 채널은 출력 핀 번호로 구분한다.
+
+// 마감 초과 시 상태기계를 정리하는 콜백 (idx: 0부터 시작하는 장비 번호)
+typedef void (*MotionAbortFn)(uint8_t idx);
+
+// 출력 pin 동작 시작: timeoutMs 안에 releaseMotion(pin) 이 없으면 fault
+// 이미 감시 중인 pin 이면 마감을 새로 건다.
+void superviseMotion(uint8_t pin, const char* device, uint8_t idx, const char* motion,
+                     unsigned long timeoutMs, MotionAbortFn onAbort = nullptr);
+
+// 정상 완료/정지 시 감시 해제 (감시 중이 아니면 무시)
+void releaseMotion(uint8_t pin);
+
+// loop() 에서 호출: 만료된 마감 처리, 상태가 정상일 때만 watchdog 갱신
+void serviceSupervisor();
+
+// watchdog 시작 (setup 에서 Link.begin() 이후 1회)
+void startWatchdog();
+
+// 긴 블로킹 초기화(로드셀 tare, USB 연결 대기 등) 중 watchdog 갱신
+void feedWatchdog();
+
+#endif // SUPERVISOR_H
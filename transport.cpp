@@ -0,0 +1,110 @@
+#include <Arduino.h>
+#include "transport.h"
+#include "supervisor.h"
+#include "memstat.h"
+
+Transport Link;
+
+#ifndef ARDUINO
+// 호스트 빌드: host/ 의 main 이 실행 인자에 따라 PTY / 소켓 스트림을 준비해 둔다
+Stream* hostTransportStream();
+#endif
+
+void Transport::begin() {
+#ifndef ARDUINO
+  _s = hostTransportStream();
+  _name = "host";
+#elif TRANSPORT == TRANSPORT_UART
+  Serial.begin(UART_BAUD);
+  while (!Serial) { ; }
+  _s = &Serial;
+#ifdef ARDUINO_ARCH_SAM
+  _uart = &Serial;
+#endif
+  _name = "uart";
+#elif !defined(ARDUINO_ARCH_SAM)
+#error "TRANSPORT_NATIVE_USB / TRANSPORT_AUTO require the Due native USB port (SerialUSB)"
+#elif TRANSPORT == TRANSPORT_NATIVE_USB
+  SerialUSB.begin(0);  // USB CDC: baud 값은 의미 없음
+  while (!SerialUSB) { feedWatchdog(); }  // 호스트가 포트를 열 때까지
+  _s = &SerialUSB;
+  _name = "usb";
+#else // TRANSPORT_AUTO
+  SerialUSB.begin(0);
+  unsigned long t0 = millis();
+  while (!SerialUSB && millis() - t0 < TRANSPORT_AUTO_WAIT_MS) { feedWatchdog(); }
+
+  if (SerialUSB) {
+    _s = &SerialUSB;
+    _name = "usb";
+  } else {
+    Serial.begin(UART_BAUD);
+    _s = &Serial;
+    _uart = &Serial;
+    _name = "uart";
+  }
+#endif
+}
+
+// 드라이버가 막히지 않고 받을 수 있는 바이트 수
+int Transport::writable() {
+#ifdef ARDUINO_ARCH_SAM
+  if (_uart) return _uart->availableForWrite();
+#endif
+  return TX_QUEUE_SIZE;  // 네이티브 USB / 호스트: 한 번에 내보냄
+}
+
+void Transport::pumpTx() {
+  if (!_s) {
+    _txLen = 0;
+    return;
+  }
+  int room = writable();
+  while (_txLen > 0 && room > 0) {
+    size_t chunk = TX_QUEUE_SIZE - _txHead;  // 큐 끝까지 이어진 부분
+    if (chunk > _txLen) chunk = _txLen;
+    if (chunk > (size_t)room) chunk = room;
+    _s->write((const uint8_t*)_tx + _txHead, chunk);
+    _txHead = (_txHead + chunk) % TX_QUEUE_SIZE;
+    _txLen -= chunk;
+    room -= chunk;
+  }
+}
+
+void Transport::drainTx(size_t room) {
+  uint32_t t0 = micros();
+  while (_s && TX_QUEUE_SIZE - _txLen < room) {
+    pumpTx();
+  }
+  noteTxBlock((uint32_t)(micros() - t0));
+}
+
+size_t Transport::write(const uint8_t* buf, size_t n) {
+  if (!_s) return 0;
+
+  if (n > TX_QUEUE_SIZE) {
+    // 큐보다 큰 덩어리: 밀린 것을 모두 보낸 뒤 직접 (막힘)
+    drainTx(TX_QUEUE_SIZE);
+    uint32_t t0 = micros();
+    size_t sent = _s->write(buf, n);
+    noteTxBlock((uint32_t)(micros() - t0));
+    return sent;
+  }
+  if (TX_QUEUE_SIZE - _txLen < n) drainTx(n);
+
+  size_t tail = (_txHead + _txLen) % TX_QUEUE_SIZE;
+  for (size_t k = 0; k < n; k++) {
+    _tx[tail] = (char)buf[k];
+    if (++tail == TX_QUEUE_SIZE) tail = 0;
+  }
+  _txLen += n;
+  noteTxBacklog(_txLen);
+
+  pumpTx();  // 지금 들어갈 만큼은 바로
+  return n;
+}
+
+void Transport::flush() {
+  drainTx(TX_QUEUE_SIZE);
+  if (_s) _s->flush();
+}
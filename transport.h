@@ -0,0 +1,59 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// =======================================================
+// === 통신 경로 (Transport)
+// =======================================================
+// 모든 송수신(RX 명령, 텔레메트리, 에러, 로그)은 Link 를 통해서만 한다.
+// 실제 포트는 빌드 시 TRANSPORT 로 고르거나, TRANSPORT_AUTO 이면 부팅 시 고른다.
+//  - TRANSPORT_UART       : Serial (프로그래밍 포트, UART0, UART_BAUD)
+//  - TRANSPORT_NATIVE_USB : SerialUSB (Due 네이티브 포트, baud 설정 무관)
+//  - TRANSPORT_AUTO       : 부팅 후 TRANSPORT_AUTO_WAIT_MS 안에 호스트가
+//                           네이티브 포트를 열면 USB, 아니면 UART
+//  - 호스트 빌드 (ARDUINO 미정의) : host/ 의 PTY / 소켓 백엔드
+
+// 송신은 소프트웨어 큐(TX_QUEUE_SIZE)에 쌓고, 제어 작업이 매 틱 pumpTx() 로
+// 드라이버 송신 버퍼 여유(UART availableForWrite)만큼만 내보낸다. 큰 상태 프레임도
+// 여러 틱에 나눠 나가므로 보고 작업이 write 에서 막혀 제어 작업을 밀어내지 않는다.
+// write 한 번은 큐에 통째로 들어가므로 프레임 / 로그 레코드가 섞이지 않는다.
+// 큐가 넘칠 때만 자리가 날 때까지 (막히며) 내보낸다.
+
+class Transport : public Stream {
+public:
+  void begin();
+  const char* name() const { return _name; }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t n) override;
+  using Print::write;
+
+  int available() override { return _s ? _s->available() : 0; }
+  int read() override { return _s ? _s->read() : -1; }
+  int peek() override { return _s ? _s->peek() : -1; }
+  void flush() override;  // 큐를 모두 내보낸 뒤 드라이버 flush
+
+  // 드라이버가 지금 받을 수 있는 만큼 큐에서 내보냄 (loop 문맥, 제어 작업 매 틱)
+  void pumpTx();
+  size_t txQueued() const { return _txLen; }
+
+private:
+  int writable();
+  void drainTx(size_t room);  // 큐 여유가 room 이상이 될 때까지 (막힘)
+
+  Stream* _s = nullptr;
+  const char* _name = "none";
+#ifdef ARDUINO_ARCH_SAM
+  UARTClass* _uart = nullptr;  // 송신 버퍼 여유 확인용 (USB 는 나눠 보낼 필요 없음)
+#endif
+
+  char _tx[TX_QUEUE_SIZE];
+  size_t _txHead = 0;
+  size_t _txLen = 0;
+};
+
+extern Transport Link;
+
+#endif // TRANSPORT_H